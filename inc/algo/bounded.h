@@ -24,20 +24,6 @@ namespace bounded
   };
   // clang-format on
 
-  struct ConstrainedExpr
-  {
-    z3::expr expression;
-    z3::expr constraint;
-
-    operator z3::expr_vector()
-    {
-      z3::expr_vector rv(expression.ctx());
-      rv.push_back(expression);
-      rv.push_back(constraint);
-      return rv;
-    }
-  };
-
   struct Marking
   {
     std::string name;
@@ -101,11 +87,16 @@ namespace bounded
     std::vector<std::string> lit_names;
     const size_t n_lits;
 
-    // constraint presently enforced in the solver
+    // constraint presently enforced through the assumptions
     std::optional<size_t> cardinality;
     // the amount of steps that are added to the solver
     // the last transition is from `current_bound-1` to `current_bound`
     std::optional<size_t> current_bound;
+    // totalizer outputs for the state at each time step: counters[t][j] holds
+    // if at least j+1 nodes are marked at t. a counter is built the first
+    // time a non-trivial cardinality bounds step t, and counts up to that
+    // cardinality + 1. the initial state is empty and has no counter
+    std::vector<std::vector<z3::expr>> counters;
 
     std::optional<TraceVec> trace;
 
@@ -119,20 +110,21 @@ namespace bounded
 
     void reset();
     z3::expr lit(std::string_view name, size_t time_step);
-    z3::expr constraint(const z3::expr_vector& lits);
-    // empty state and cardinality clase (index 0)
-    ConstrainedExpr initial();
-    // final state for the last state and cardinality
-    ConstrainedExpr final();
+    // assumptions that bound the states up to time step `length` by the
+    // cardinality. builds the counters these need
+    z3::expr_vector bound(size_t length);
+    // empty state (index 0)
+    z3::expr initial();
+    // final state at time step `length`
+    z3::expr final(size_t length);
     // returns the transition for step i -> i+1
-    // with the cardinality clause for step i+1
-    ConstrainedExpr trans_step(size_t i);
-    // transition relations for an amount of steps
+    z3::expr trans_step(size_t i);
+    // transition relations and counters for an amount of steps
     void push_transitions(size_t steps);
 
     z3::check_result check(size_t steps, double allowance);
 
-    pdr::PdrResult::Trace::TraceVec get_trace(size_t length) const;
+    pdr::PdrResult::Trace::TraceVec get_trace(size_t length);
     std::string strategy_table(const std::vector<TraceRow>& content) const;
     void store_strategy(size_t length);
     void dump_times(std::ostream& out) const;
@@ -0,0 +1,134 @@
+#ifndef PDR_CUBE_H
+#define PDR_CUBE_H
+
+#include "expr.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <z3++.h>
+
+namespace pdr
+{
+  // a literal of a cube as 2 * atom + negated, where atom is the index of its
+  // variable in a LitTable
+  using lit_t = uint32_t;
+  // literals sorted by their code. two cubes over the same LitTable compare
+  // and subsume without touching z3
+  using Cube    = std::vector<lit_t>;
+  using CubeSet = std::set<Cube>;
+
+  inline lit_t mk_lit(uint32_t atom, bool negated)
+  {
+    return 2 * atom + negated;
+  }
+  inline uint32_t atom(lit_t l) { return l >> 1; }
+  inline bool negated(lit_t l) { return l & 1; }
+
+  // non-owning view of a cube stored elsewhere (such as the arena of a Frame)
+  class CubeView
+  {
+   public:
+    CubeView(lit_t const* b, lit_t const* e) : first(b), last(e) {}
+    CubeView(Cube const& c) : first(c.data()), last(c.data() + c.size()) {}
+
+    lit_t const* begin() const { return first; }
+    lit_t const* end() const { return last; }
+    size_t size() const { return last - first; }
+    lit_t operator[](size_t i) const { return first[i]; }
+    Cube to_cube() const { return Cube(first, last); }
+
+   private:
+    lit_t const* first;
+    lit_t const* last;
+  };
+
+  // returns true if l < r
+  // assumes l and r are in sorted order
+  template <typename L, typename R> bool subsumes_l(L const& l, R const& r)
+  {
+    if (l.size() >= r.size())
+      return false;
+
+    return std::includes(r.begin(), r.end(), l.begin(), l.end());
+  }
+
+  // returns true if l <= r
+  // assumes l and r are in sorted order
+  template <typename L, typename R> bool subsumes_le(L const& l, R const& r)
+  {
+    if (l.size() > r.size())
+      return false;
+
+    return std::includes(r.begin(), r.end(), l.begin(), l.end());
+  }
+
+  template <typename L, typename R> bool equal_cubes(L const& l, R const& r)
+  {
+    return l.size() == r.size() && std::equal(l.begin(), l.end(), r.begin());
+  }
+
+  // handling cubes of the form: < c1, c2, ..., cn, constraint_lit >
+  // order maps the code of each constraint literal to the size of its
+  // constraint. see z3ext::constrained_cube
+  namespace constrained_cube
+  {
+    // add "constraint" to cube, unless it already contains a tighter one
+    Cube mk_constrained_cube(std::map<lit_t, size_t> const& order,
+        Cube cube,
+        lit_t constraint);
+
+    // true if a is stronger than b.
+    bool subsumes_l(std::map<lit_t, size_t> const& order,
+        Cube const& a,
+        Cube const& b);
+    bool subsumes_le(std::map<lit_t, size_t> const& order,
+        Cube const& a,
+        Cube const& b);
+  } // namespace constrained_cube
+
+  // assigns every atom in a cube (a variable or reserved literal) an index,
+  // and converts between z3 literals and their lit_t code.
+  // the variables of the model are registered first, so atom i is vars(i)
+  class LitTable
+  {
+   public:
+    LitTable(mysat::primed::VarVec const& v);
+
+    // encoding. atoms that are not yet known are registered
+    lit_t operator()(z3::expr const& l);
+    Cube operator()(std::vector<z3::expr> const& lits);
+    Cube operator()(z3::expr_vector const& lits);
+
+    // decoding
+    z3::expr operator()(lit_t l) const;
+    // the literal in the next state. reserved literals remain the same
+    z3::expr p(lit_t l) const;
+    std::vector<z3::expr> to_vec(Cube const& c) const;
+    z3::expr_vector to_expr_vec(Cube const& c) const;
+    z3::expr_vector p(Cube const& c) const;
+    // the negation of the cube
+    z3::expr clause(Cube const& c) const;
+
+    size_t size() const;
+    // true if c is over variables of the model only. the codes of those are
+    // the same in every LitTable for the same model
+    bool portable(CubeView c) const;
+    std::string to_string(CubeView c, std::string const& delimiter = ", ") const;
+
+   private:
+    mysat::primed::VarVec const& vars;
+    z3::expr_vector atoms;
+    z3::expr_vector atoms_p;
+    // id() of an atom -> its index
+    std::unordered_map<unsigned, uint32_t> index;
+
+    uint32_t add_atom(z3::expr const& a);
+  };
+} // namespace pdr
+#endif // PDR_CUBE_H
@@ -1,6 +1,7 @@
 #ifndef FRAME
 #define FRAME
 
+#include "cube.h"
 #include "logger.h"
 #include "solver.h"
 #include "stats.h"
@@ -21,39 +22,81 @@ namespace pdr
   class Frame
   {
    private:
-    // the arguments of the clause are sorted by mic, use id to search
-    z3ext::CubeSet blocked_cubes;
+    static constexpr uint32_t REMOVED = UINT32_MAX;
+
+    // a blocked cube: lits [offset, offset + size) of the arena
+    struct Entry
+    {
+      uint32_t offset;
+      uint32_t size;
+      // bloom filter of the literals: if a subsumes b, then a's bits are a
+      // subset of b's
+      uint64_t signature;
+      // index in blocked_cubes, or REMOVED
+      uint32_t position;
+    };
+
+    // the literals of all blocked cubes, stored back to back
+    std::vector<lit_t> arena;
+    // every cube that was added since the last compact()
+    std::vector<Entry> entries;
+    // indices of the entries that are still blocked
+    std::vector<uint32_t> blocked_cubes;
+    // lit -> all entries that contain lit
+    std::vector<std::vector<uint32_t>> occurs;
+    // lit -> entries that are indexed by lit, their rarest literal at the time
+    // they were blocked. every entry is in exactly one list
+    std::vector<std::vector<uint32_t>> watches;
+    // entries for the empty cube, which has no literal to be indexed by
+    std::vector<uint32_t> empty_cubes;
+    // number of literals in the arena that belong to removed cubes
+    size_t garbage{ 0 };
     const unsigned level;
 
+    static uint64_t signature(CubeView c);
+    CubeView view(Entry const& e) const;
+    CubeView view(uint32_t id) const;
+    void insert(Cube const& cube);
+    // remove the entry. its index lists are cleaned by compact()
+    void erase(uint32_t id);
+    // reclaim the space of removed cubes once they make up half the frame
+    void compact();
+    void index(uint32_t id);
+    // the literal of cube with the shortest occurs list
+    lit_t rarest(CubeView cube) const;
+
    public:
     Frame(unsigned i);
 
     void clear();
 
     // remove any weaker cubes in the frame
-    unsigned remove_subsumed(
-        const std::vector<z3::expr>& cube, bool remove_equal);
+    unsigned remove_subsumed(Cube const& cube, bool remove_equal);
     // remove any weaker cubes in the frame, specialized for constrained cubes.
     // slower than regular, used during relaxation phase
     unsigned remove_subsumed_constrained(
-        std::map<unsigned, size_t> const& order,
-        const std::vector<z3::expr>& cube,
+        std::map<lit_t, size_t> const& order,
+        Cube const& cube,
         bool remove_equal);
 
     // check if a stronger cube has already been blocked
-    bool is_subsumed(std::vector<z3::expr> const& cube) const;
-    bool block(std::vector<z3::expr> const& cube);
+    bool is_subsumed(Cube const& cube) const;
+    bool block(Cube const& cube);
 
     // Frame comparisons
     bool equals(const Frame& f) const;
-    std::vector<std::vector<z3::expr>> diff(const Frame& f) const;
+    std::vector<Cube> diff(const Frame& f) const;
 
     // getters
-    z3ext::CubeSet const& get() const;
+    // a sorted copy of all blocked cubes
+    CubeSet get() const;
+    // access to the blocked cubes without copying. invalidated by changes
+    size_t size() const;
+    CubeView operator[](size_t i) const;
     bool empty() const;
 
     // string representations
-    std::string blocked_str() const;
+    std::string blocked_str(LitTable const& lits) const;
   };
 } // namespace pdr
 
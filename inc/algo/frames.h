@@ -1,10 +1,14 @@
 #ifndef FRAMES
 #define FRAMES
 
+#include "cube.h"
 #include "frame.h"
+#include "inductive-cache.h"
+#include "lemma-exchange.h"
 #include "logger.h"
 #include "pdr-context.h"
 #include "pdr-model.h"
+#include "propagation.h"
 #include "solver.h"
 #include "stats.h"
 #include "z3-ext.h"
@@ -24,6 +28,9 @@ namespace pdr
    public:
     // solver containing only the intial state
     z3::solver init_solver; // TODO immutable interface
+    // the encoding of the cubes in the frames. conversion to z3 happens only
+    // when a cube goes to a solver
+    LitTable lits;
 
     Frames(Context c, IModel& m, Logger& l);
 
@@ -57,6 +64,19 @@ namespace pdr
     void copy_to_Fk_keep(
         size_t old_step, z3::expr_vector const& old_constraint);
 
+    // the portable cubes of each frame and the shape of the sequence. enough
+    // to continue relaxing ipdr in another process
+    struct Snapshot
+    {
+      std::vector<Lemma> cubes; // each with the frame it is stored in
+      size_t n_frames{ 2 };
+      std::optional<unsigned> detached_frontier;
+    };
+    Snapshot snapshot() const;
+    // replace the sequence by a snapshot taken under the same model and
+    // constraint
+    void restore(Snapshot const& s);
+
     // constraining ipdr functions
     //
     // redo propagation for the previous level
@@ -73,30 +93,58 @@ namespace pdr
     // state removal functions
     //
     //
-    bool remove_state(const std::vector<z3::expr>& cube, size_t level);
+    bool remove_state(Cube const& cube, size_t level);
+    // remove a state learned by another pdr instance. unlike remove_state(),
+    // it is not published again
+    bool import_state(Cube const& cube, size_t level);
     // removes a state and handles subsumption with cube constrained.
     // slower that regular remove state. used only during relaxation
-    bool remove_state_constrained(
-        const std::vector<z3::expr>& cube, size_t level);
+    bool remove_state_constrained(Cube const& cube, size_t level);
+    // block the images of a cube learned by pdr under the model's
+    // symmetries, each once it is checked to be inductive relative to the
+    // frames. not done for propagated or copied cubes
+    void remove_symmetric(Cube const& cube, size_t level);
     std::optional<size_t> propagate();
     std::optional<size_t> propagate(size_t k);
     void push_forward_delta(size_t level, bool repeat = false);
+    // break off the checks of the propagation workers, from another thread
+    void interrupt();
 
     // query functions over the state space the frames represent
     //
+    // returns true if cube intersects with the initial states
+    bool intersects_initial(Cube const& cube);
     // returns true if the negation of cube is inductive relative to F_frame
-    bool inductive(const std::vector<z3::expr>& cube, size_t frame);
+    bool inductive(Cube const& cube, size_t frame);
+    // inductive(), memoized until cubes are blocked at frame or above. the
+    // answer holds the core or witness that would be read from the solver
+    InductiveCache::Answer inductive_cached(Cube const& cube, size_t frame);
+    // the literals of "cube" in the unsat core of the last inductive() query
+    // to solver(frame), in the current state
+    Cube core_current(size_t frame);
+    // a predecessor from a satisfiable query. only cube is set if
+    // Context::lift is not
+    struct Predecessor
+    {
+      Cube cube;  // the lifted predecessor
+      Cube state; // the full predecessor in the model, in cube
+      Cube next;  // its full successor in the model, as current literals
+    };
     // returns a cube in `F_frame \cup !cube` that leads to a cube-state
-    std::optional<std::vector<z3::expr>> counter_to_inductiveness(
-        const std::vector<z3::expr>& cube, size_t frame);
+    std::optional<Predecessor> counter_to_inductiveness(
+        Cube const& cube, size_t frame);
+    // the current state of the last satisfiable query to solver(frame)
+    Cube witness_current(size_t frame);
+    // the literals of "pred", a predecessor of "succ", that still force the
+    // transition into succ. all of pred if Context::lift is not set
+    std::vector<z3::expr> lift(
+        std::vector<z3::expr> const& pred, std::vector<z3::expr> const& succ);
 
     // returns if there exists a transition from frame to cube,
     // allows collection of witness from solver(frame) if true.
-    // if primed: cube is already in next state, else first convert it
-    bool trans_source(size_t frame,
-        const std::vector<z3::expr>& dest_cube,
-        bool primed = false);
-    // returns the witness to a transition if it exists, else none
+    bool trans_source(size_t frame, Cube const& dest_cube);
+    // returns the witness to a transition if it exists, else none.
+    // the witness is a full state, see lift()
     std::optional<z3ext::solver::Witness> get_trans_source(size_t frame,
         const std::vector<z3::expr>& dest_cube,
         bool primed = false);
@@ -104,7 +152,7 @@ namespace pdr
     // returns true if the given cube or a stronger cube is already blocked
     // at level
     std::optional<size_t> already_blocked(
-        std::vector<z3::expr> const& cube, size_t level) const;
+        Cube const& cube, size_t level) const;
 
     // getters
     //
@@ -117,7 +165,10 @@ namespace pdr
     const Solver& get_solver(size_t frame) const;
     const Frame& operator[](size_t i);
     // returns all cubes blocked in Frame i. adjusted for delta encoding.
-    z3ext::CubeSet get_blocked_in(size_t i) const;
+    CubeSet get_blocked_in(size_t i) const;
+    // the portable cubes of every level, each with the highest level it is
+    // blocked in
+    std::vector<Lemma> learned() const;
 
     // logging and output
     //
@@ -139,6 +190,10 @@ namespace pdr
 
     Solver FI_solver;
     Solver delta_solver;
+    // answers propagation queries if Context::propagation_threads > 1. kept
+    // in sync with delta_solver lazily, at the start of each parallel level
+    std::unique_ptr<PropagationPool> pool;
+    InductiveCache inductive_answers;
     // activation variables for each frame. if present in a query, the clauses
     // from the corresponding frame are loaded
     std::vector<z3::expr> act;
@@ -152,14 +207,18 @@ namespace pdr
     // activation literals for incremental relaxing.
     // maps: i -> clit[i]
     std::map<size_t, z3::expr> clits;
-    // stored for easy detection in z3ext::mk_constrained_cube()
-    // clit[i].id() -> i
-    std::map<unsigned, size_t> clit_ids;
+    // stored for easy detection in constrained_cube::mk_constrained_cube()
+    // lits(clit[i]) -> i
+    std::map<lit_t, size_t> clit_codes;
 
     void new_constraint(size_t i, z3::expr_vector const& clauses);
+    // push_forward_delta() with the trans_source queries answered by pool
+    void push_forward_parallel(size_t level, bool repeat);
 
     void init_frames();
     void new_frame();
+    // block the cubes of every frame in the delta_solver
+    void block_all();
     void refresh_solver_if_clogged();
     // define each of the "constraints" in a logic formula:
     // expr(__constraint{i}__) <=> constraint[i]
@@ -172,11 +231,10 @@ namespace pdr
     // delta-encoding and "cube" has been blocked at "level" in the
     // "delta_solver".
     // @return: true if "cube" was newly removed, false if it was already.
-    bool delta_remove_state(const std::vector<z3::expr>& cube, size_t level);
+    bool delta_remove_state(Cube const& cube, size_t level);
     // state removal for the delta-encoding with constrained cubes.
     // called by remove_state_constrained().
-    bool delta_remove_state_constrained(
-        const std::vector<z3::expr>& cube, size_t level);
+    bool delta_remove_state_constrained(Cube const& cube, size_t level);
   };
 
 } // namespace pdr
@@ -0,0 +1,63 @@
+#ifndef INDUCTIVE_CACHE_H
+#define INDUCTIVE_CACHE_H
+
+#include "cube.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace pdr
+{
+  struct CubeHash
+  {
+    size_t operator()(Cube const& c) const;
+  };
+
+  // memoizes the relative inductiveness queries of Frames, keyed by cube and
+  // level. F_i is the union of the cubes blocked at levels i and above, so
+  // blocking a cube at level j only changes the answers for levels <= j.
+  // blocking more cubes never breaks inductiveness, so those answers are kept
+  // until clear(). a counterexample is kept while no cube is blocked at its
+  // level or above
+  class InductiveCache
+  {
+   public:
+    struct Answer
+    {
+      bool inductive;
+      // the literals of the queried cube in the unsat core if inductive,
+      // else the current state of the counterexample
+      Cube cube;
+    };
+
+    // the stored answer, if it is still valid
+    std::optional<Answer> find(Cube const& cube, size_t level) const;
+    void store(Cube const& cube, size_t level, Answer answer);
+    // a cube was blocked at "level", which changes F_1 ... F_level
+    void blocked(size_t level);
+    // forget all answers. for when frames are removed or the constraint
+    // changes
+    void clear();
+
+    size_t size() const;
+
+   private:
+    // entries per level, a level is cleared once it holds this many
+    static constexpr size_t MAX_ENTRIES = 1u << 16;
+
+    struct Entry
+    {
+      Answer answer;
+      uint64_t version;
+    };
+
+    // versions[i] counts the cubes blocked at level i or above
+    std::vector<uint64_t> versions;
+    std::vector<std::unordered_map<Cube, Entry, CubeHash>> entries;
+  };
+} // namespace pdr
+
+#endif // INDUCTIVE_CACHE_H
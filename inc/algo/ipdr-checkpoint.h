@@ -0,0 +1,42 @@
+#ifndef IPDR_CHECKPOINT_H
+#define IPDR_CHECKPOINT_H
+
+#include "frames.h"
+#include "io.h"
+#include "pdr-model.h"
+
+#include <optional>
+#include <vector>
+
+namespace pdr::pebbling
+{
+  // the progress of pebbling::IPDR::relax after its last proven bound: the
+  // pdr runs so far and the frames they left. another process restores it to
+  // continue with the next bound
+  struct RelaxCheckpoint
+  {
+    // a pdr run that proved "constraint" pebbles to be too few
+    struct Step
+    {
+      unsigned constraint;
+      int level; // of the invariant
+      double time;
+    };
+
+    // the setting of relax(). a checkpoint continues only the same setting
+    bool control{ false };
+    bool simple_relax{ true };
+
+    std::vector<Step> steps;
+    std::vector<double> inc_times; // before every step but the first
+    Frames::Snapshot frames;       // after the last step
+
+    // the checkpoint in "file", none if there is no such file. throws if the
+    // file is damaged or belongs to another model
+    static std::optional<RelaxCheckpoint> load(
+        my::io::fs::path const& file, IModel const& model);
+    void save(my::io::fs::path const& file, IModel const& model) const;
+  };
+} // namespace pdr::pebbling
+
+#endif // IPDR_CHECKPOINT_H
@@ -0,0 +1,39 @@
+#ifndef LEMMA_EXCHANGE_H
+#define LEMMA_EXCHANGE_H
+
+#include "cube.h"
+#include "mpsc-queue.h"
+
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace pdr
+{
+  // a cube that was blocked in frames 1..level by some pdr instance
+  struct Lemma
+  {
+    Cube cube;
+    unsigned level;
+  };
+
+  // the endpoint of one portfolio instance for sharing lemmas with the others.
+  // cubes are exchanged as lit_t codes, so they are only meaningful between
+  // instances of the same model (see LitTable::portable)
+  class LemmaChannel
+  {
+   public:
+    LemmaChannel(std::vector<std::unique_ptr<LemmaChannel>> const& all);
+
+    // send to every other channel. callable from any thread
+    void publish(Cube const& cube, unsigned level);
+    // the next lemma sent by another instance. owner thread only
+    std::optional<Lemma> receive();
+
+   private:
+    std::vector<std::unique_ptr<LemmaChannel>> const& peers;
+    my::MpscQueue<Lemma> inbox;
+  };
+} // namespace pdr
+
+#endif // LEMMA_EXCHANGE_H
@@ -0,0 +1,53 @@
+#ifndef LEMMA_STORE_H
+#define LEMMA_STORE_H
+
+#include "io.h"
+#include "lemma-exchange.h"
+#include "pdr-model.h"
+
+#include <cstdint>
+#include <istream>
+#include <optional>
+#include <ostream>
+#include <vector>
+
+namespace pdr
+{
+  // a hash of the model's variables, initial states and transition. with
+  // "constraint", also of its current constraint
+  uint64_t model_key(IModel const& model, bool constraint);
+
+  // lemmas in binary, as LitTable codes
+  void write_lemmas(std::ostream& out, std::vector<Lemma> const& lemmas);
+  // none if "in" ends early or holds a cube over more than n_vars variables
+  std::optional<std::vector<Lemma>> read_lemmas(
+      std::istream& in, size_t n_vars);
+
+  // the cubes pdr blocked for a model, kept in a directory between runs.
+  // a file belongs to one hash of the model's variables, initial states,
+  // transition and constraint. cubes are stored as LitTable codes, so only
+  // portable cubes can be kept (see LitTable::portable).
+  // loaded lemmas are claims, pdr checks them before it blocks them
+  class LemmaStore
+  {
+   public:
+    LemmaStore(my::io::fs::path const& dir, IModel const& model);
+
+    // the lemmas stored for the model in its current state. empty if there
+    // are none or the file does not match
+    std::vector<Lemma> load() const;
+    // replace the lemmas stored for the model in its current state
+    void save(std::vector<Lemma> const& lemmas) const;
+
+    // the file of the model in its current state
+    my::io::fs::path file() const;
+
+   private:
+    my::io::fs::path dir;
+    IModel const& model;
+
+    my::io::fs::path file(uint64_t key) const;
+  };
+} // namespace pdr
+
+#endif // LEMMA_STORE_H
@@ -2,8 +2,10 @@
 #define PDR_OBL_H
 
 #include "TextTable.h"
+#include "cube.h"
 #include "z3-ext.h"
 
+#include <deque>
 #include <fmt/format.h>
 #include <numeric>
 #include <string>
@@ -12,36 +14,126 @@
 
 namespace pdr
 {
+  class PdrState;
+  class StatePool;
+
+  // counted reference to a PdrState from a StatePool. the count lives in the
+  // state itself and is not atomic: a pool belongs to a single pdr instance
+  class StateRef
+  {
+   public:
+    StateRef() = default;
+    StateRef(StateRef const& other);
+    StateRef(StateRef&& other) noexcept;
+    StateRef& operator=(StateRef other) noexcept;
+    ~StateRef();
+
+    PdrState* get() const { return node; }
+    PdrState& operator*() const { return *node; }
+    PdrState* operator->() const { return node; }
+    explicit operator bool() const { return node != nullptr; }
+
+   private:
+    friend class StatePool;
+    PdrState* node{ nullptr };
+
+    explicit StateRef(PdrState* s);
+    // unlinks the node and recycles every state in the chain that is no
+    // longer referenced
+    void release();
+  };
+
   class PdrState
   {
    public:
-    std::vector<z3::expr> cube;
-    std::shared_ptr<PdrState> prev; // store predecessor for trace
+    Cube cube;     // may be lifted. used for blocking and queries
+    StateRef prev; // store predecessor for trace
+    // the full state of the model that cube was taken from, and its
+    // successor in that model, which lies in prev->cube. empty if cube is
+    // that full state and prev->cube is its successor
+    Cube witness;
+    Cube witness_next;
 
-    PdrState(const std::vector<z3::expr>& e);
-    PdrState(const std::vector<z3::expr>& e, std::shared_ptr<PdrState> s);
-    // move constructors
-    PdrState(std::vector<z3::expr>&& e);
-    PdrState(std::vector<z3::expr>&& e, std::shared_ptr<PdrState> s);
+    PdrState(const Cube& e);
+    PdrState(Cube&& e);
+    // a state holds a reference count, copies would not be tracked
+    PdrState(PdrState const&)            = delete;
+    PdrState& operator=(PdrState const&) = delete;
 
-    unsigned show(TextTable& table) const;
+    unsigned show(TextTable& table, LitTable const& lits) const;
+    // the full states of the trace that starts in this state. the
+    // successor of the last state is not included
+    std::vector<Cube> trace() const;
 
     unsigned no_marked() const;
+
+   private:
+    friend class StateRef;
+    friend class StatePool;
+    unsigned refs{ 0 };
+    StatePool* pool{ nullptr }; // null if the state is not pool-allocated
+  };
+
+  // allocates PdrStates and recycles them once unreferenced. must outlive
+  // every StateRef it hands out
+  class StatePool
+  {
+   public:
+    StatePool() = default;
+    StatePool(StatePool const&)            = delete;
+    StatePool& operator=(StatePool const&) = delete;
+    // states keep their address, but are pointed to the new pool
+    StatePool(StatePool&& other);
+    StatePool& operator=(StatePool&& other);
+    ~StatePool();
+
+    StateRef make(Cube&& cube);
+    StateRef make(Cube&& cube,
+        StateRef prev,
+        Cube witness      = {},
+        Cube witness_next = {});
+
+    // number of states ever allocated, live or free
+    size_t capacity() const;
+    size_t n_free() const;
+
+   private:
+    friend class StateRef;
+    std::deque<PdrState> states; // deque: growing keeps addresses stable
+    std::vector<PdrState*> free_states;
+
+    void recycle(PdrState* s);
   };
 
   struct Obligation
   {
     unsigned level;
-    std::shared_ptr<PdrState> state;
+    StateRef state;
     unsigned depth;
 
-    Obligation(unsigned k, std::vector<z3::expr>&& cube, unsigned d);
+    Obligation(unsigned k, StateRef s, unsigned d);
+  };
+
+  // obligations ranked by level, then by depth. levels are buckets, so
+  // finding the lowest level is constant time while the levels are bounded
+  // by the frontier. each bucket is a heap on depth
+  class ObligationQueue
+  {
+   public:
+    void clear();
+    bool empty() const;
+    size_t size() const;
 
-    Obligation(unsigned k, const std::shared_ptr<PdrState>& s, unsigned d);
+    void push(unsigned level, StateRef state, unsigned depth);
+    // the obligation with the lowest level and depth
+    // the reference is invalidated by push()
+    Obligation const& top() const;
+    void pop();
 
-    // bool operator<(const Obligation& o) const { return this->level <
-    // o.level; }
-    bool operator<(const Obligation& o) const;
+   private:
+    std::vector<std::vector<Obligation>> buckets;
+    size_t lowest{ 0 }; // every bucket below is empty
+    size_t n_obligations{ 0 };
   };
 } // namespace pdr
 #endif // PDR_OBL
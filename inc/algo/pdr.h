@@ -4,6 +4,8 @@
 #include "cli-parse.h"
 #include "dag.h"
 #include "frames.h"
+#include "io.h"
+#include "ipdr-checkpoint.h"
 #include "pdr-context.h"
 #include "pdr-model.h"
 #include "pebbling-model.h"
@@ -68,6 +70,7 @@ namespace pdr
 
     Statistics& stats();
     void show_solver(std::ostream& out) const override;
+    void interrupt() override;
     std::vector<std::string> trace_row(std::vector<z3::expr> const& v);
     int length_shortest_strategy() const;
 
@@ -81,29 +84,54 @@ namespace pdr
     spdlog::stopwatch sub_timer;
 
     Frames frames; // sequence of candidates
-    std::set<Obligation, std::less<Obligation>> obligations;
+    StatePool states; // declared first: obligations refer to its states
+    ObligationQueue obligations;
 
     struct HIFresult
     {
       int level;
-      std::optional<std::vector<z3::expr>> core;
+      std::optional<Cube> core;
     };
 
+    // outcomes of plain MIC on a level, for MicMode::ctg_adaptive
+    struct MicRecord
+    {
+      unsigned attempts{ 0 }; // literals plain MIC tried to drop
+      unsigned failures{ 0 }; // of which could not be dropped
+      bool ctg{ false };      // the level uses MICctg from now on
+    };
+    std::vector<MicRecord> mic_records;
+
+    // lemmas from Context::lemma_cache that are not yet blocked, and the
+    // frontier at which they were last tried
+    std::vector<Lemma> stored_lemmas;
+    size_t stored_frontier{ 0 };
+
     void print_model(z3::model const& m);
     // main algorithm
     PdrResult init();
     PdrResult iterate();
-    PdrResult block(std::vector<z3::expr>&& cti, unsigned n);
+    // cti may be lifted, cti_state is the full state it was lifted from
+    PdrResult block(Cube&& cti, Cube&& cti_state, unsigned n);
+    // add the lemmas received from other portfolio instances that are
+    // inductive relative to these frames
+    void import_lemmas();
+    // block the stored lemmas that are inductive relative to these frames.
+    // they are tried once per frontier, until they reach their own level
+    void import_stored_lemmas();
+    // write the blocked and still pending lemmas to Context::lemma_cache
+    void save_lemmas();
     // generalization
     // todo return [n, cti ptr]
-    HIFresult hif_(std::vector<z3::expr> const& cube, int min);
-    HIFresult highest_inductive_frame(
-        std::vector<z3::expr> const& cube, int min);
-    void generalize(std::vector<z3::expr>& cube, int level);
-    void MIC(std::vector<z3::expr>& cube, int level);
-    void MICctg(std::vector<z3::expr>& cube, int level, unsigned depth);
-    bool down(std::vector<z3::expr>& cube, int level);
-    bool ctgdown(std::vector<z3::expr>& cube, int level, unsigned depth);
+    HIFresult hif_(Cube const& cube, int min);
+    HIFresult highest_inductive_frame(Cube const& cube, int min);
+    void generalize(Cube& cube, int level);
+    void MIC(Cube& cube, int level);
+    // decide if MIC on this level uses ctgs, as set by ctx.mic
+    bool use_ctg(int level);
+    void MICctg(Cube& cube, int level, unsigned depth);
+    bool down(Cube& cube, int level);
+    bool ctgdown(Cube& cube, int level, unsigned depth);
     // results
     void make_result(PdrResult& result);
     // to replace return value in run()
@@ -163,8 +191,19 @@ namespace pdr
       std::optional<unsigned> starting_pebbles;
       bool control_setting;
       bool simple_relax;
+      // written by relax() after every bound it proves
+      std::optional<my::io::fs::path> checkpoint;
+      bool resume; // let relax() continue from checkpoint
+      RelaxCheckpoint progress;
 
       void basic_reset(unsigned pebbles);
+      // restores the steps of the checkpoint into "total", and the model and
+      // frames after its last step
+      // @return: the last bound of the checkpoint, none if there is no file
+      std::optional<unsigned> resume_relax(IpdrPebblingResult& total);
+      // add a run of relax() to the checkpoint and write it, if the run found
+      // an invariant
+      void save_progress(PdrResult const& r, std::optional<double> inc_time);
       void relax_reset(unsigned pebbles);
       void relax_reset_constrained(unsigned pebbles);
       std::optional<size_t> constrain_reset(unsigned pebbles);
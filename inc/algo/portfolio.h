@@ -0,0 +1,55 @@
+#ifndef PDR_PORTFOLIO_H
+#define PDR_PORTFOLIO_H
+
+#include "lemma-exchange.h"
+#include "pdr-context.h"
+#include "result.h"
+#include "vpdr.h"
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace pdr
+{
+  // races pdr instances on separate threads. the first one to find an
+  // invariant or a trace wins, the others are interrupted.
+  // every instance needs its own z3::context, model and logger.
+  // if lemmas are shared, every cube an instance blocks is offered to the
+  // others, which import it if it is inductive relative to their frames
+  class Portfolio
+  {
+   public:
+    struct Outcome
+    {
+      size_t winner;
+      PdrResult result;
+    };
+
+    Portfolio(bool share_lemmas);
+
+    // the settings of the ith instance: all instances listen to the same
+    // interrupt flag, and all but the first use a different seed and
+    // generalization settings
+    Context configure(Context c, unsigned i);
+
+    // add an instance that was constructed with configure()
+    void add(vPDR& instance);
+    size_t size() const;
+
+    // run all instances concurrently until one finishes.
+    // rethrows the first error if none of them finish
+    Outcome run();
+
+   private:
+    std::atomic<bool> stop{ false };
+    bool share;
+    std::vector<vPDR*> instances;
+    // channels[i] belongs to instance i. fixed once run() starts
+    std::vector<std::unique_ptr<LemmaChannel>> channels;
+  };
+} // namespace pdr
+
+#endif // PDR_PORTFOLIO_H
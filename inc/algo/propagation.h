@@ -0,0 +1,58 @@
+#ifndef PDR_PROPAGATION_H
+#define PDR_PROPAGATION_H
+
+#include "pdr-context.h"
+#include "solver-backend.h"
+
+#include <memory>
+#include <optional>
+#include <vector>
+#include <z3++.h>
+
+namespace pdr
+{
+  // answers the trans_source queries of a propagation phase on several
+  // threads. every worker owns a z3 context with a copy of the delta solver,
+  // which must be brought up to date through sync() before each query.
+  // the pool lives as long as the frames, so only new clauses are copied
+  class PropagationPool
+  {
+   public:
+    PropagationPool(Context const& ctx, unsigned n_workers);
+
+    // copy the assertions and activation literals of the delta solver that
+    // are new since the last sync into every worker. everything is copied
+    // again if the solver's generation has changed (see Solver::generation)
+    void sync(z3::expr_vector const& assertions, unsigned generation,
+        std::vector<z3::expr> const& act);
+    // break off the checks of every worker. may be called from any thread
+    void interrupt();
+
+    // for each primed cube: true if it has a predecessor in F_level.
+    // cube j is checked by worker j % n_workers, so the result does not
+    // depend on scheduling
+    std::vector<bool> trans_source(
+        size_t level, std::vector<z3::expr_vector> const& dest_p);
+
+    size_t size() const;
+
+   private:
+    struct Worker
+    {
+      z3::context z3_ctx;
+      Context ctx;
+      std::shared_ptr<ISolverBackend> solver;
+      std::vector<z3::expr> act;
+
+      Worker(Context const& settings);
+    };
+
+    // fixed at construction, so interrupt() may read it concurrently
+    std::vector<std::unique_ptr<Worker>> workers;
+    // the state of the delta solver the workers were last synced with
+    std::optional<unsigned> synced_generation;
+    unsigned n_synced{ 0 };
+  };
+} // namespace pdr
+
+#endif // PDR_PROPAGATION_H
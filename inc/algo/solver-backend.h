@@ -0,0 +1,131 @@
+#ifndef SOLVER_BACKEND_H
+#define SOLVER_BACKEND_H
+
+#include "cdcl.h"
+#include "pdr-context.h"
+
+#include <functional>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+#include <z3++.h>
+
+namespace pdr
+{
+  // the propositional solver behind pdr::Solver.
+  // formulas and assumptions are given as z3 expressions, backends may
+  // convert them to their own representation
+  class ISolverBackend
+  {
+   public:
+    virtual ~ISolverBackend() {}
+
+    // remove all assertions and backtracking points
+    virtual void reset()                                  = 0;
+    virtual void push()                                   = 0;
+    virtual void pop(unsigned n = 1)                      = 0;
+    virtual void add(z3::expr const& e)                   = 0;
+    virtual bool check(z3::expr_vector const& assumptions) = 0;
+
+    // all assertions in the order they were added
+    virtual z3::expr_vector assertions() const = 0;
+    // the literals assigned in the last model to the constants that satisfy p
+    virtual std::vector<z3::expr> model_lits(
+        std::function<bool(z3::expr const&)> const& p) const = 0;
+    // the values of the given constants in the last model, in the same order.
+    // empty if the model does not assign a constant
+    virtual std::vector<std::optional<bool>> model_values(
+        z3::expr_vector const& constants) const = 0;
+    // the subset of assumptions used in the last unsat proof
+    virtual std::vector<z3::expr> unsat_core() const = 0;
+
+    void add(z3::expr_vector const& ev)
+    {
+      for (z3::expr const& e : ev)
+        add(e);
+    }
+
+    // create the backend selected in ctx
+    static std::shared_ptr<ISolverBackend> make(Context const& ctx);
+  };
+
+  class Z3Backend final : public ISolverBackend
+  {
+   public:
+    Z3Backend(Context const& ctx);
+
+    void reset() override;
+    void push() override;
+    void pop(unsigned n = 1) override;
+    void add(z3::expr const& e) override;
+    bool check(z3::expr_vector const& assumptions) override;
+
+    z3::expr_vector assertions() const override;
+    std::vector<z3::expr> model_lits(
+        std::function<bool(z3::expr const&)> const& p) const override;
+    std::vector<std::optional<bool>> model_values(
+        z3::expr_vector const& constants) const override;
+    std::vector<z3::expr> unsat_core() const override;
+
+   private:
+    z3::solver solver;
+    std::atomic<bool> const* interrupt;
+  };
+
+  // the embedded mysat::cdcl solver. every z3 constant becomes a variable,
+  // other subformulas are given a tseitin variable (memoized)
+  class CdclBackend final : public ISolverBackend
+  {
+   public:
+    CdclBackend(Context const& ctx);
+
+    void reset() override;
+    void push() override;
+    void pop(unsigned n = 1) override;
+    void add(z3::expr const& e) override;
+    bool check(z3::expr_vector const& assumptions) override;
+
+    z3::expr_vector assertions() const override;
+    std::vector<z3::expr> model_lits(
+        std::function<bool(z3::expr const&)> const& p) const override;
+    std::vector<std::optional<bool>> model_values(
+        z3::expr_vector const& constants) const override;
+    std::vector<z3::expr> unsat_core() const override;
+
+   private:
+    using lit_t = mysat::cdcl::lit_t;
+    using var_t = mysat::cdcl::var_t;
+
+    z3::context& z3_ctx;
+    uint32_t seed;
+    std::atomic<bool> const* interrupt;
+    std::unique_ptr<mysat::cdcl::Solver> sat;
+
+    // id() of an encoded expression -> its literal.
+    std::unordered_map<unsigned, lit_t> encoded;
+    // keeps encoded expressions alive, so their ids are not reused
+    z3::expr_vector encoded_exprs;
+    // the z3 constants that have a variable
+    std::vector<std::pair<var_t, z3::expr>> constants;
+    std::optional<lit_t> true_lit;
+
+    z3::expr_vector asserted;
+    std::vector<unsigned> scope_marks;
+    z3::expr_vector last_assumptions;
+    std::vector<lit_t> last_assumption_lits;
+
+    // assert e without a tseitin variable for its top-level and/or
+    void assert_top(z3::expr const& e);
+    lit_t lit(z3::expr const& e);
+    lit_t encode(z3::expr const& e);
+    lit_t mk_and(std::vector<lit_t> const& args);
+    lit_t mk_or(std::vector<lit_t> const& args);
+    lit_t mk_xor(lit_t a, lit_t b);
+    lit_t mk_ite(lit_t c, lit_t t, lit_t e);
+    // literal that is true iff more than k of args are true
+    lit_t mk_more_than(std::vector<lit_t> const& args, unsigned k);
+    lit_t mk_true();
+  };
+} // namespace pdr
+#endif // SOLVER_BACKEND_H
@@ -1,12 +1,14 @@
 #ifndef SOLVER_H
 #define SOLVER_H
 #include "pdr-context.h"
+#include "solver-backend.h"
 #include "z3-ext.h"
 
 #include <exception>
 #include <fmt/core.h>
 #include <memory>
 #include <numeric>
+#include <optional>
 #include <set>
 #include <vector>
 #include <z3++.h>
@@ -27,6 +29,9 @@ namespace pdr
     // clauses (and are thus redundant)
     unsigned n_subsumed{ 0 };
     unsigned n_clauses{ 0 };
+    // incremented whenever assertions are removed. as long as it is
+    // unchanged, assertions() only grows
+    unsigned generation{ 0 };
 
     Solver(Context& ctx, const IModel& m, z3::expr_vector base,
         z3::expr_vector t, z3::expr_vector con);
@@ -36,13 +41,20 @@ namespace pdr
     unsigned n_assertions() const;
     // return the fraction of assertions in the solver that are subsumed
     double frac_subsumed() const;
+    // all assertions, including the base, transition and constraint
+    z3::expr_vector assertions() const;
 
     void remake(z3::expr_vector base, z3::expr_vector transition,
         z3::expr_vector constraint);
     void reset();
     void reset(const z3ext::CubeSet& cubes);
-    // sets a new ccnf constraint, removes all blocked cubes
+    // sets a new ccnf constraint, removes all blocked cubes. if the
+    // constraint is unchanged, it is kept in the solver
     void reconstrain_clear(z3::expr_vector constraint);
+    // sets a ccnf constraint that implies the current one. blocked cubes
+    // remain valid and are kept. the old constraint is replaced at the next
+    // reset(). does nothing if the constraint is unchanged
+    void reconstrain_tighten(z3::expr_vector constraint);
     // adds a cube's clause to the solver
     void block(const z3::expr_vector& cube);
     void block(const z3::expr_vector& cube, const z3::expr& act);
@@ -51,9 +63,12 @@ namespace pdr
     void block(const z3ext::CubeSet& cubes, const z3::expr& act);
 
     bool SAT(const z3::expr_vector& assumptions);
-    z3::model get_model() const;
-    z3::model witness_raw() const;
+    // the state variables of type t in the last model, in cube order. only
+    // the state variables are evaluated
+    std::vector<z3::expr> witness(mysat::primed::lit_type t) const;
     z3::expr_vector witness_current() const;
+    // the current state variables in the last model, and without simple
+    // relaxation the reserved constraint literals it assigns
     std::vector<z3::expr> std_witness_current() const;
     std::vector<z3::expr> witness_current_intersect(
         const std::vector<z3::expr>& vec) const;
@@ -65,10 +80,9 @@ namespace pdr
     // is in sorted order template UnaryPredicate: function expr->bool to
     // filter atoms. accepts 1 expr, returns bool
     template <typename UnaryPredicate>
-    static z3::expr_vector filter_witness(const z3::model& m, UnaryPredicate p);
+    z3::expr_vector filter_witness(UnaryPredicate p) const;
     template <typename UnaryPredicate>
-    static std::vector<z3::expr> filter_witness_vector(
-        const z3::model& m, UnaryPredicate p);
+    std::vector<z3::expr> filter_witness_vector(UnaryPredicate p) const;
 
     // function extract the unsat_core from the solver, a subset of the
     // assumptions the resulting vector or expr_vector is in sorted order
@@ -115,55 +129,38 @@ namespace pdr
         }
       }
 
-      static InvalidExtraction NonConstant(const z3::expr& e)
-      {
-        return InvalidExtraction(
-            fmt::format("witness contains non-constant: {}", e.to_string()));
-      }
-
       const char* what() const noexcept override { return message.c_str(); }
     };
 
     const mysat::primed::VarVec& vars;
-    z3::solver internal_solver;
+    // z3 or the embedded cdcl solver, see Context::cdcl. shared so the
+    // solver copies like z3::solver does
+    std::shared_ptr<ISolverBackend> internal_solver;
     SolverState state{ SolverState::fresh };
     // point where base ends transition assertions begin
     unsigned transition_start;
     // point where base_assertions ends and other assertions begin
     unsigned clauses_start;
+    // a tightened constraint, asserted among the blocked cubes until reset()
+    std::optional<z3::expr_vector> pending_constraint;
+    unsigned n_pending{ 0 };
+    // a copy of the constraint in the solver, models may modify theirs
+    z3::expr_vector current_constraint;
   };
 
   template <typename UnaryPredicate>
-  z3::expr_vector Solver::filter_witness(const z3::model& m, UnaryPredicate p)
+  z3::expr_vector Solver::filter_witness(UnaryPredicate p) const
   {
-    std::vector<z3::expr> std_vec = filter_witness_vector(m, p);
-    z3::expr_vector v(std_vec[0].ctx());
-    for (const z3::expr& e : std_vec)
-      v.push_back(e);
-    return v;
+    return z3ext::convert(filter_witness_vector(p));
   }
 
   template <typename UnaryPredicate>
-  std::vector<z3::expr> Solver::filter_witness_vector(
-      const z3::model& m, UnaryPredicate p)
+  std::vector<z3::expr> Solver::filter_witness_vector(UnaryPredicate p) const
   {
-    std::vector<z3::expr> v;
-    v.reserve(m.num_consts());
-    for (unsigned i = 0; i < m.size(); i++)
-    {
-      z3::func_decl f  = m[i];
-      z3::expr b_value = m.get_const_interp(f);
-      z3::expr literal = f();
-      if (p(literal))
-      {
-        if (b_value.is_true())
-          v.push_back(literal);
-        else if (b_value.is_false())
-          v.push_back(!literal);
-        else
-          throw InvalidExtraction::NonConstant(b_value);
-      }
-    }
+    if (state != SolverState::witness_available)
+      throw InvalidExtraction(state);
+
+    std::vector<z3::expr> v = internal_solver->model_lits(p);
     z3ext::order_lits(v);
 
     return v;
@@ -1,6 +1,7 @@
 #ifndef VPDR_H
 #define VPDR_H
 
+#include "cube.h"
 #include "logger.h"
 #include "pdr-context.h"
 #include "pdr-model.h"
@@ -37,6 +38,10 @@ namespace pdr
 
     virtual void show_solver(std::ostream& out) const = 0;
 
+    // break off the solver calls in progress, from another thread. only
+    // stops the run if Context::interrupt is set as well
+    virtual void interrupt() { ctx.z3_ctx.interrupt(); }
+
    protected:
     IModel& ts;
 
@@ -47,10 +52,11 @@ namespace pdr
     void log_propagation(unsigned level, double time);
     void log_top_obligation(size_t queue_size,
         unsigned top_level,
-        std::vector<z3::expr> const& top);
-    void log_pred(std::vector<z3::expr> const& p);
+        Cube const& top,
+        LitTable const& lits);
+    void log_pred(Cube const& p, LitTable const& lits);
     void log_state_push(unsigned frame);
-    void log_finish_state(std::vector<z3::expr> const& s);
+    void log_finish_state(Cube const& s);
     void log_obligation_done(std::string_view type, unsigned l, double time);
     void log_pdr_finish(PdrResult const& r, double final_time);
   };
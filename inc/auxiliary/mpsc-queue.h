@@ -0,0 +1,61 @@
+#ifndef MPSC_QUEUE_H
+#define MPSC_QUEUE_H
+
+#include <atomic>
+#include <optional>
+#include <utility>
+
+namespace my
+{
+  // unbounded lock-free queue for many producers and a single consumer
+  // (vyukov). push() may be called from any thread, pop() only from the owner.
+  template <typename T> class MpscQueue
+  {
+   public:
+    MpscQueue() : head(new Node), tail(head.load()) {}
+    MpscQueue(MpscQueue const&) = delete;
+    MpscQueue& operator=(MpscQueue const&) = delete;
+
+    ~MpscQueue()
+    {
+      while (pop())
+        ;
+      delete tail;
+    }
+
+    void push(T value)
+    {
+      Node* n = new Node(std::move(value));
+      Node* prev = head.exchange(n, std::memory_order_acq_rel);
+      // until this store, the consumer sees the queue as ending at prev
+      prev->next.store(n, std::memory_order_release);
+    }
+
+    std::optional<T> pop()
+    {
+      Node* next = tail->next.load(std::memory_order_acquire);
+      if (!next)
+        return {};
+
+      std::optional<T> rv(std::move(next->value));
+      delete tail;
+      tail = next; // next becomes the stub
+      return rv;
+    }
+
+   private:
+    struct Node
+    {
+      std::atomic<Node*> next{ nullptr };
+      T value;
+
+      Node() = default;
+      Node(T&& v) : value(std::move(v)) {}
+    };
+
+    std::atomic<Node*> head; // last pushed node, shared by producers
+    Node* tail;              // stub before the first element, consumer only
+  };
+} // namespace my
+
+#endif // MPSC_QUEUE_H
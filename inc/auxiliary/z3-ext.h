@@ -416,7 +416,7 @@ namespace z3ext
 
   namespace tseytin
   {
-    // convert e to cnf using z3's simplify and tseitin conversion tactics
+    // convert e to an equisatisfiable cnf using tseytin::Encoder
     z3::expr_vector to_cnf_vec(z3::expr e);
     z3::expr to_cnf(z3::expr const& e);
 
@@ -454,6 +454,15 @@ namespace z3ext
         std::string const& name,
         z3::expr const& a,
         z3::expr const& b);
+
+    // add a totalizer over "lits" to "cnf" and return its outputs, of which
+    // there are at most "cap". output j holds if at least j+1 lits hold.
+    // only the upward direction is encoded: assuming !output[k] enforces
+    // atmost(lits, k)
+    std::vector<z3::expr> add_totalizer(z3::expr_vector& cnf,
+        std::string const& name,
+        z3::expr_vector const& lits,
+        size_t cap);
   } // namespace tseytin
 } // namespace z3ext
 #endif // Z3_EXT
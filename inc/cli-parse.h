@@ -4,6 +4,7 @@
 #include "dag.h"
 #include "io.h"
 #include "logger.h"
+#include "mic-mode.h"
 #include "tactic.h"
 
 #include <array>
@@ -30,6 +31,9 @@ namespace my::cli
     {
       std::string name;
       fs::path file;
+      // read gate by gate with parse::read_bench, instead of through
+      // mockturtle's xmg decomposition
+      bool gates{ false };
     };
 
     struct tfcFile
@@ -59,20 +63,31 @@ namespace my::cli
     {
       std::optional<unsigned> max_pebbles; // starting value for constraint
       Graph_var src;
+      bool reduce{ false }; // see dag::Graph::reduced()
     };
 
     struct Peterson
     {
       unsigned processes;
       std::optional<unsigned> switch_bound;
+      // steps explored by PetersonModel::check_symmetry instead of a run
+      std::optional<unsigned> symmetry_check;
     };
 
-    using Model_var = std::variant<Pebbling, Peterson>;
+    struct Aiger
+    {
+      std::string name;
+      fs::path file; // .aig or .aag
+    };
+
+    using Model_var = std::variant<Pebbling, Peterson, Aiger>;
 
     std::string src_name(Model_var const& m);
     std::string describe(Model_var const& m);
     std::string get_name(Model_var const& m);
     std::string filetag(Model_var const& m);
+    // the graph of the source, reduced if requested
+    dag::Graph make_graph(Pebbling const& m);
   } // namespace model_t
 
   namespace algo
@@ -134,11 +149,21 @@ namespace my::cli
     std::optional<Experiment> experiment;
     std::variant<bool, unsigned> r_seed;
     std::optional<bool> skip_blocked;
+    std::optional<bool> lift;
+    std::optional<bool> symmetry;
     std::optional<unsigned> mic_retries;
+    std::optional<pdr::MicMode> mic_mode;
     std::optional<double> subsumed_cutoff;
     std::optional<unsigned> ctg_max_depth;
     std::optional<unsigned> ctg_max_counters;
+    std::optional<unsigned> portfolio; // race this many pdr instances
+    bool share_lemmas; // let portfolio instances exchange blocked cubes
+    std::optional<unsigned> propagation_threads;
+    std::optional<fs::path> lemma_cache; // directory of stored lemmas
     bool simple_relax{ true }; // else do constrained copy
+    std::optional<fs::path> checkpoint; // file of ipdr relax progress
+    bool resume; // continue ipdr relax from checkpoint
+    bool cdcl;     // use the embedded cdcl solver for pdr's queries
     bool tseytin;  // encode pebbling::Model transition using tseyting enconding
     bool onlyshow; // only read in and produce the model image and description
     bool control_run;
@@ -172,8 +197,9 @@ namespace my::cli
     inline static const std::string o_problem  = "problem";
     inline static const std::string s_pebbling = "pebbling";
     inline static const std::string s_peter    = "peterson";
+    inline static const std::string s_aiger    = "aiger";
     inline static const std::vector<std::string> problem_group{ s_pebbling,
-      s_peter };
+      s_peter, s_aiger };
 
     inline static const std::string s_z3pdr = "z3pdr";
 
@@ -192,19 +218,26 @@ namespace my::cli
     inline static const std::string s_binary = pdr::tactic::binary_search_str;
 
     inline static const std::string s_pebbles = "pebbles";
+    inline static const std::string s_reduce  = "reduce";
     inline static const std::string s_mprocs  = "max_procs";
     inline static const std::string s_mswitch = "max_switches";
     inline static const std::string s_procs   = "procs";
+    inline static const std::string s_check_symmetry = "check-symmetry";
 
     inline static const std::string s_dir   = "dir";
     inline static const std::string s_bench = "bench";
+    inline static const std::string s_bench_gates = "bench-gates";
     inline static const std::string s_tfc   = "tfc";
     inline static const std::string s_hop   = "hop";
+    inline static const std::string s_aig   = "aig";
 
-    inline static const std::string s_rand    = "rand";
-    inline static const std::string s_seed    = "seed";
-    inline static const std::string s_tseytin = "tseytin";
-    inline static const std::string s_show    = "show-only";
+    inline static const std::string s_rand      = "rand";
+    inline static const std::string s_seed      = "seed";
+    inline static const std::string s_tseytin   = "tseytin";
+    inline static const std::string s_cdcl      = "cdcl";
+    inline static const std::string s_portfolio = "portfolio";
+    inline static const std::string s_share     = "share-lemmas";
+    inline static const std::string s_show      = "show-only";
 
     inline static const std::string s_verbose = "verbose";
     inline static const std::string s_whisper = "whisper";
@@ -212,10 +245,17 @@ namespace my::cli
 
     inline static const std::string s_copy_constrain = "copy-constrain";
     inline static const std::string s_skip_blocked = "skip-blocked";
+    inline static const std::string s_lift         = "lift";
+    inline static const std::string s_symmetry     = "symmetry";
     inline static const std::string s_mic          = "mic-attempts";
+    inline static const std::string s_mic_mode     = "mic";
     inline static const std::string s_subsumed     = "cut-subsumed";
     inline static const std::string s_ctgdepth     = "ctg-depth";
     inline static const std::string s_ctgnum       = "max-ctgs";
+    inline static const std::string s_prop_threads = "propagation-threads";
+    inline static const std::string s_lemma_cache  = "lemma-cache";
+    inline static const std::string s_checkpoint   = "checkpoint";
+    inline static const std::string s_resume       = "resume";
   };
 } // namespace my::cli
 #endif // CLI_H
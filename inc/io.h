@@ -4,6 +4,9 @@
 #include <ghc/filesystem.hpp>
 // #include <filesystem>
 #include <fstream>
+#include <functional>
+#include <istream>
+#include <ostream>
 #include <string>
 #include <string_view>
 
@@ -24,6 +27,42 @@ namespace my::io
   // creates it with the the given extension, in the given folder.
   std::ofstream trunc_file(fs::path const& folder, std::string const& filename,
       std::string const& ext);
+  // writes a binary file through "write" to a temporary file next to "path",
+  // then moves it over "path". readers never see a partial file
+  void replace_file(
+      fs::path const& path, std::function<void(std::ostream&)> const& write);
+
+  // the bytes of a trivially copyable value, in host byte order
+  template <typename T> void write_raw(std::ostream& out, T const& v)
+  {
+    out.write(reinterpret_cast<char const*>(&v), sizeof(T));
+  }
+  // false if "in" ends before the value
+  template <typename T> bool read_raw(std::istream& in, T& v)
+  {
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(&v), sizeof(T)));
+  }
+
+  // a file's contents mapped read-only into memory, for parsers that keep
+  // views into it. the views are valid while the MappedFile lives
+  class MappedFile
+  {
+   public:
+    // throws std::invalid_argument if the file cannot be read
+    MappedFile(fs::path const& path);
+    ~MappedFile();
+    MappedFile(MappedFile const&)            = delete;
+    MappedFile& operator=(MappedFile const&) = delete;
+
+    std::string_view text() const { return { data, size }; }
+
+   private:
+    char const* data{ nullptr };
+    size_t size{ 0 };
+#ifdef _WIN32
+    std::string buffer; // without mmap, the file is read into memory
+#endif
+  };
 
   // run_type_dir / model_type_dir / model_dir / run_dir / run_files
   // ex: output / experiments / ipdr / pebbling / ham3tc /
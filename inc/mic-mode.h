@@ -0,0 +1,28 @@
+#ifndef PDR_MIC_MODE_H
+#define PDR_MIC_MODE_H
+
+#include <string>
+#include <string_view>
+
+namespace pdr
+{
+  // the generalization performed by PDR::MIC
+  enum class MicMode
+  {
+    plain,       // drop literals with down()
+    ctg,         // drop literals with ctgdown(), blocking ctgs on the way
+    ctg_adaptive // plain, switching to ctg on levels where down() often fails
+  };
+
+  namespace mic
+  {
+    inline static const std::string plain_str{ "plain" };
+    inline static const std::string ctg_str{ "ctg" };
+    inline static const std::string ctg_adaptive_str{ "ctg-adaptive" };
+
+    MicMode mk_mode(std::string_view s);
+    std::string to_string(MicMode m);
+  } // namespace mic
+} // namespace pdr
+
+#endif // PDR_MIC_MODE_H
@@ -0,0 +1,59 @@
+#ifndef AIGER_MODEL
+#define AIGER_MODEL
+
+#include <string>
+#include <vector>
+#include <z3++.h>
+
+#include "cli-parse.h"
+#include "expr.h"
+#include "parse_aiger.h"
+#include "pdr-model.h"
+
+namespace pdr::aiger
+{
+  // a safety problem read from an and-inverter graph in the AIGER format
+  //
+  // state: one variable per latch ("l{i}") and one for the property ("bad")
+  // inputs ("i{i}") and and-gates ("a{var}") are free, non-state variables
+  //
+  // initial: latches at their reset value (0 if none given), bad <- 0
+  //
+  // transition: and-gates in tseitin form, l{i}' <-> next(l{i}),
+  //  bad' <-> (some bad/output literal) & all invariant constraints.
+  //  invariant constraints must also hold for the current state.
+  //
+  // property: !bad
+  class AigerModel : public pdr::IModel
+  {
+   public:
+    AigerModel(const my::cli::ArgumentList& args, z3::context& c,
+        const parse::Aiger& aig);
+
+    size_t n_inputs() const;
+    size_t n_latches() const;
+    size_t n_ands() const;
+
+    const z3::expr get_constraint_current() const override;
+    unsigned state_size() const override;
+    const std::string constraint_str() const override;
+    unsigned constraint_num() const override;
+
+   private:
+    // z3::expr_vector initial;
+    // z3::expr_vector transition; // vector of clauses (cnf)
+    // z3::expr_vector constraint; // unused: aiger has no ipdr constraint
+
+    size_t inputs, latches, ands;
+    // aiger variable index -> expression
+    std::vector<z3::expr> var_map;
+
+    static std::vector<std::string> latch_names(const parse::Aiger& aig);
+    z3::expr lit(unsigned l) const;
+    void load_reset(const parse::Aiger& aig);
+    void load_aig_transition(const parse::Aiger& aig);
+    void load_property();
+  };
+} // namespace pdr::aiger
+
+#endif // !AIGER_MODEL
@@ -1,102 +1,130 @@
 #ifndef DAG_H
 #define DAG_H
 
-#include "graphvizgraph.h"
 #include "string-ext.h"
 
 #include <cassert>
+#include <cstdint>
 #include <fmt/format.h>
 #include <ghc/filesystem.hpp>
-#include <graphviz/gvc.h>
 #include <map>
 #include <memory>
+#include <optional>
 #include <set>
 #include <sstream>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
 namespace dag
 {
-  struct Edge
-  {
-    std::string from;
-    std::string to;
+  // index of a node in Graph::nodes()
+  using node_t = uint32_t;
 
-    Edge(std::string const& f, std::string const& t) : from(f), to(t) {}
+  // a view on a slice of node indices
+  class NodeRange
+  {
+   public:
+    NodeRange(node_t const* b, node_t const* e) : first(b), last(e) {}
 
-    friend bool operator<(Edge const& lhs, Edge const& rhs)
-    {
-      if (lhs.from < rhs.from)
-        return true;
-      if (rhs.from < lhs.from)
-        return false;
-
-      if (lhs.to < rhs.to)
-        return true;
-      return false;
-    }
+    node_t const* begin() const { return first; }
+    node_t const* end() const { return last; }
+    size_t size() const { return last - first; }
+    bool empty() const { return first == last; }
+    node_t operator[](size_t i) const { return first[i]; }
 
-    friend std::stringstream& operator<<(
-        std::stringstream& stream, Edge const& e)
-    {
-      stream << "(" << e.from << ", " << e.to << ")";
-      return stream;
-    }
+   private:
+    node_t const* first;
+    node_t const* last;
   };
 
+  // a graph is filled by the add_ functions and then build(), which numbers
+  // the nodes in order of their names and packs the children of every node
+  // in one array (compressed sparse rows). the names are only kept for
+  // output and lookups by find(). after build() the graph is read-only.
+  // graphviz is only used to render an image in show_image()
   class Graph
   {
    public:
     std::string name;
     std::string prefix = "";
 
-    std::set<std::string> input;
-    std::set<std::string> nodes;
-    std::set<std::string, std::less<>> output; // subet of nodes
-    std::set<Edge> edges;                      // nodes X nodes
-
     std::string node(std::string name) { return prefix + name; }
 
     Graph();
-    Graph(Graph const& G);
     Graph(std::string const& s);
-    Graph(std::string const& s, std::string const& dot);
 
     void add_input(std::string iname);
     void add_node(std::string nname);
     void add_output(std::string oname);
     void add_edges_to(std::vector<std::string> from, std::string to);
+    // freeze the added nodes and edges into the packed representation
+    void build();
+    bool is_built() const { return !staged.has_value(); }
+
+    // a copy without the nodes that no output depends on. the optimum is the
+    // same, since those nodes are never pebbled in an optimal strategy
+    Graph reduced() const;
+
+    size_t n_nodes() const { return names.size(); }
+    size_t n_inputs() const { return inputs.size(); }
+    size_t n_outputs() const { return output_ids.size(); }
+    // distinct edges between nodes, edges from inputs are not counted
+    size_t n_edges() const { return targets.size(); }
+
+    // the names of the nodes, sorted. node i is named nodes()[i]
+    std::vector<std::string> const& nodes() const { return names; }
+    std::vector<std::string> const& input_names() const { return inputs; }
+    std::vector<node_t> const& outputs() const { return output_ids; }
+    std::string const& name_of(node_t n) const { return names[n]; }
+    std::optional<node_t> find(std::string_view name) const;
+
+    bool is_output(node_t n) const { return output_flags[n]; }
+    // the nodes that n depends on, in the order they were added
+    NodeRange children(node_t n) const
+    {
+      assert(is_built());
+      return { targets.data() + offsets[n], targets.data() + offsets[n + 1] };
+    }
 
     std::string summary() const;
     std::string DAG_string() const;
 
-    // write a dot image to the destination (path/filename without extension)
-    void show_image(std::string const& destination);
-    // write a dot image and text description
-    void show(std::string const& destination, bool to_cout, bool brief);
-
-    std::string dot();
-
-    bool is_output(std::string_view name) const;
+    // lay out and render an svg image to the destination (path/filename
+    // without extension). expensive for large graphs
+    void show_image(std::string const& destination) const;
+    // write the text description to destination.txt
+    void describe(
+        std::string const& destination, bool to_cout, bool brief) const;
+    // write an image and text description
+    void show(std::string const& destination, bool to_cout, bool brief) const;
 
-    const std::vector<std::string>& get_children(std::string_view key) const;
+    std::string dot() const;
 
    private:
-    std::map<std::string, std::vector<std::string>, std::less<>>
-        children;               // nodes X nodes
-    std::set<Edge> input_edges; // nodes X nodes
-    std::vector<std::string> empty_vec;
-    std::unique_ptr<graphviz::Graph> image;
+    // the graph as it is added to, before build()
+    struct Staging
+    {
+      std::set<std::string> input;
+      std::set<std::string> nodes;
+      std::set<std::string> output; // subset of nodes
+      std::map<std::string, std::vector<std::string>> children;
+      std::vector<std::pair<std::string, std::string>> input_edges;
+    };
+    std::optional<Staging> staged;
+
+    std::vector<std::string> names;  // sorted
+    std::vector<std::string> inputs; // sorted
+    std::vector<node_t> output_ids;  // sorted
+    std::vector<bool> output_flags;
+    // the children of node i are targets[offsets[i] .. offsets[i+1])
+    std::vector<node_t> offsets;
+    std::vector<node_t> targets;
+    // (index in inputs, node), sorted
+    std::vector<std::pair<node_t, node_t>> input_edges;
+
+    Staging& staging();
   };
 } // namespace dag
-
-// formatter for edges
-template <> struct fmt::formatter<dag::Edge> : fmt::formatter<std::string_view>
-{
-  auto format(dag::Edge e, fmt::format_context& ctx) const
-  {
-    std::string e_str = "(" + e.from + ", " + e.to + ")"; 
-    return fmt::formatter<std::string_view>::format(e_str, ctx);
-  }
-};
 #endif // DAG_H
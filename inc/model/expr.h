@@ -5,6 +5,9 @@
 #include <bitset>
 #include <climits>
 #include <fmt/color.h>
+#include <optional>
+#include <unordered_map>
+#include <vector>
 #include <z3++.h>
 
 namespace mysat::primed
@@ -126,6 +129,12 @@ namespace mysat::primed
     z3::expr_vector p(z3::expr_vector const& ev) const;
     z3::expr_vector p(std::vector<z3::expr> const& ev) const;
 
+    // the cube of type "t" assigned by "values", which is indexed like
+    // get(t). unassigned variables are left out. the result is in the order of
+    // z3ext::cube_orderer without sorting
+    std::vector<z3::expr> ordered_cube(
+        std::vector<std::optional<bool>> const& values, lit_type t) const;
+
     // returns true if "e" is an unprimed variable from VarVec or if it a
     // reserved literal
     bool lit_is_current(z3::expr const& e) const;
@@ -140,6 +149,19 @@ namespace mysat::primed
     std::unordered_map<unsigned, size_t> to_current;
     std::unordered_map<unsigned, size_t> to_next;
 
+    // both literals of every variable, sorted by z3ext::cube_orderer
+    struct OrderedLit
+    {
+      z3::expr lit;
+      size_t index; // of the variable in current/next
+      bool value;   // the assignment that gives lit
+    };
+    std::vector<OrderedLit> ordered_current;
+    std::vector<OrderedLit> ordered_next;
+
+    // rebuild the ordered literals after variables are added
+    void order();
+
   }; // class VarVec
 
   // a vector of boolean expressionos
@@ -255,6 +277,8 @@ namespace mysat::primed
 
    private:
     z3::expr_vector carry_out;
+    // maps id() of a current or next bit to its index
+    std::unordered_map<unsigned, size_t> bit_index;
 
     z3::expr_vector unint_to_lits(
         numrep_t n, lit_type t = lit_type::base) const;
@@ -308,6 +332,41 @@ namespace mysat::primed
     // z3::expr rec_less(const BitVec& x, size_t msb, size_t nbits) const;
   };
 
+  // locates a variable of a model: the value it belongs to, its bit in that
+  // value (0 for a Lit) and whether it is the primed version
+  struct Symbol
+  {
+    unsigned owner;
+    unsigned bit;
+    lit_type type;
+  };
+
+  // maps z3 ast ids of a model's variables to their Symbol, so a cube is
+  // decoded in one pass over its literals
+  class SymbolTable
+  {
+   public:
+    using numrep_t = BitVec::numrep_t;
+
+    // register all current and next bits, returns the owner index
+    unsigned add(BitVec const& v);
+    unsigned add(Lit const& v);
+
+    // the symbol of the variable in "lit", nullptr if it is not registered
+    Symbol const* find(z3::expr const& lit) const;
+    // number of registered values
+    size_t size() const;
+
+    // the value of every owner as assigned by the literals of type "t" in
+    // "cube". bits that do not occur are false
+    std::vector<numrep_t> decode(z3::expr_vector const& cube,
+        lit_type t = lit_type::base) const;
+
+   private:
+    std::unordered_map<unsigned, Symbol> symbols;
+    unsigned n_owners{ 0 };
+  };
+
   void bv_comp_test(size_t max_value);
   void bv_val_test(size_t max_value);
   void bv_inc_test(size_t max_value);
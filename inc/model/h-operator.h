@@ -4,6 +4,7 @@
 #include <cstdint>
 #include <iostream>
 #include <sstream>
+#include <string>
 #include <vector>
 
 #include <mockturtle/algorithms/klut_to_graph.hpp>
@@ -76,25 +77,62 @@ inline xmg_network build_hoperator(uint64_t bitwidth, uint64_t modulus)
 
 namespace dag
 {
-  inline Graph from_dot(const xmg_network& network, const std::string& name)
+  // the graph of a mockturtle network (xmg, aig, ...), read from the network
+  // itself. nodes are named as the labels of my_dot_drawer: inputs "in_i",
+  // constants "const_i" and gates "n_i", for node index i. complemented
+  // fanins are plain edges
+  template <typename Ntk>
+  Graph from_network(Ntk const& network, std::string const& name)
   {
-    std::stringstream dot_string;
-    my_dot_drawer<xmg_network> drawer;
-    write_dot(network, dot_string, drawer);
-
-    return dag::Graph(name, dot_string.str());
+    using node = typename Ntk::node;
+    auto node_name = [&network](node const& n)
+    {
+      auto i = network.node_to_index(n);
+      if (network.is_pi(n))
+        return fmt::format("in_{}", i);
+      if (network.is_constant(n))
+        return fmt::format("const_{}", i);
+      return fmt::format("n_{}", i);
+    };
+
+    Graph G(name);
+    network.foreach_node(
+        [&](node const& n)
+        {
+          if (network.is_pi(n))
+            G.add_input(node_name(n));
+          else
+            G.add_node(node_name(n));
+        });
+
+    network.foreach_gate(
+        [&](node const& n)
+        {
+          std::vector<std::string> children;
+          network.foreach_fanin(n, [&](auto const& f)
+              { children.push_back(node_name(network.get_node(f))); });
+          G.add_edges_to(children, node_name(n));
+        });
+
+    network.foreach_po([&](auto const& f)
+        { G.add_output(node_name(network.get_node(f))); });
+
+    G.build();
+    return G;
   }
 
-  inline Graph from_dot(const klut_network& network, const std::string& name)
+  // the luts of a klut network are first decomposed into xmg gates
+  inline Graph from_network(
+      const klut_network& network, const std::string& name)
   {
     xmg_network xmg = convert_klut_to_graph<xmg_network>(network);
-    return from_dot(xmg, name);
+    return from_network(xmg, name);
   }
 
   inline Graph hoperator(uint64_t bitwidth, uint64_t modulus)
   {
     xmg_network h = build_hoperator(bitwidth, modulus);
-    return from_dot(h, fmt::format("hoperator_{}_{}", bitwidth, modulus));
+    return from_network(h, fmt::format("hoperator_{}_{}", bitwidth, modulus));
   }
 
 } // namespace dag
@@ -0,0 +1,45 @@
+#ifndef PARSE_AIGER
+#define PARSE_AIGER
+
+#include <string>
+#include <vector>
+
+namespace parse
+{
+  // an and-inverter graph as described by the AIGER format (version 1.9)
+  // literals are unsigned: 2 * var + sign. var 0 is the constant false.
+  // latches, inputs and and-gates are stored in the order of the file.
+  struct Aiger
+  {
+    struct Latch
+    {
+      unsigned lit;
+      unsigned next;
+      unsigned reset; // 0, 1, or lit (uninitialized)
+    };
+
+    struct And
+    {
+      unsigned lhs;
+      unsigned rhs0;
+      unsigned rhs1;
+    };
+
+    unsigned max_var{ 0 };
+    std::vector<unsigned> inputs;
+    std::vector<Latch> latches;
+    std::vector<unsigned> outputs;
+    std::vector<unsigned> bad;
+    std::vector<unsigned> constraints;
+    std::vector<And> ands;
+
+    static unsigned var(unsigned lit) { return lit >> 1; }
+    static bool sign(unsigned lit) { return lit & 1; }
+  };
+
+  // read an .aig (binary) or .aag (ascii) file, determined by its header.
+  // justice and fairness properties are read but discarded.
+  // throws std::invalid_argument on malformed input
+  Aiger read_aiger(std::string const& filename);
+} // namespace parse
+#endif // PARSE_AIGER
@@ -0,0 +1,90 @@
+#ifndef PARSE_TEXT
+#define PARSE_TEXT
+
+#include <cctype>
+#include <fmt/core.h>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace parse
+{
+  // s without whitespace at either end
+  inline std::string_view trim(std::string_view s)
+  {
+    while (!s.empty() && std::isspace(static_cast<unsigned char>(s.front())))
+      s.remove_prefix(1);
+    while (!s.empty() && std::isspace(static_cast<unsigned char>(s.back())))
+      s.remove_suffix(1);
+    return s;
+  }
+
+  // the trimmed text before the first "delim" in s. s is advanced past it,
+  // or emptied if there is none
+  inline std::string_view next_token(std::string_view& s, char delim)
+  {
+    size_t end             = s.find(delim);
+    std::string_view token = trim(s.substr(0, end));
+    s.remove_prefix(end == std::string_view::npos ? s.size() : end + 1);
+    return token;
+  }
+
+  inline bool starts_with(std::string_view s, std::string_view prefix)
+  {
+    return s.substr(0, prefix.size()) == prefix;
+  }
+
+  // the lines of a text in one pass, without copies. keeps the position of
+  // the current line for error messages
+  class Lines
+  {
+   public:
+    Lines(std::string const& f, std::string_view t) : filename(f), text(t) {}
+
+    // the next line that is not empty or a comment, trimmed. false at the end
+    bool next(std::string_view& line)
+    {
+      while (pos < text.size())
+      {
+        size_t end = text.find('\n', pos);
+        if (end == std::string_view::npos)
+          end = text.size();
+        current = text.substr(pos, end - pos);
+        pos     = end + 1;
+        line_no++;
+
+        line = trim(current);
+        if (!line.empty() && line.front() != comment)
+          return true;
+      }
+      current = text.substr(text.size());
+      return false;
+    }
+
+    // number of the current line, from 1
+    unsigned line() const { return line_no; }
+
+    // "filename:line:column: what". the column is that of "at" if it views
+    // the current line
+    std::invalid_argument error(
+        std::string_view what, std::string_view at = {}) const
+    {
+      if (at.data() && at.data() >= current.data() &&
+          at.data() <= current.data() + current.size())
+        return std::invalid_argument(fmt::format("{}:{}:{}: {}", filename,
+            line_no, at.data() - current.data() + 1, what));
+      return std::invalid_argument(
+          fmt::format("{}:{}: {}", filename, line_no, what));
+    }
+
+   private:
+    static constexpr char comment = '#';
+
+    std::string const& filename;
+    std::string_view text;
+    std::string_view current; // untrimmed
+    size_t pos{ 0 };
+    unsigned line_no{ 0 };
+  };
+} // namespace parse
+#endif // PARSE_TEXT
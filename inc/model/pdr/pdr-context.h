@@ -2,14 +2,20 @@
 #define PDRCONTEXT_H
 
 #include "cli-parse.h"
+#include "mic-mode.h"
 #include "pdr-model.h"
 #include "tactic.h"
 
+#include <atomic>
 #include <cstdint>
+#include <optional>
+#include <stdexcept>
 #include <z3++.h>
 
 namespace pdr
 {
+  class LemmaChannel;
+
   // class containing algorithm settings
   // only consists of references or simple types
   // cheap to copy
@@ -30,10 +36,18 @@ namespace pdr
     // If false: reconsider these weaker cubes to
     // potentially generalize them into a stronger cube
     bool skip_blocked;
+    // if true: reduce the predecessors in PDR::block to the literals that
+    // still force the transition, through IModel::lift()
+    bool lift;
+    // if true: a blocked cube is blocked together with its images under the
+    // symmetries of the model, through IModel::symmetric()
+    bool symmetry;
 
     // in PDR::MIC if mic fails to reduce a clause this many times, consider the
     // current clause sufficient
     uint32_t mic_retries;
+    // the generalization used by PDR::MIC
+    MicMode mic;
     // Frames refreshes its solver, removing subsumed cubes, once this fraction
     // of asserted clauses are subsumed
     double subsumed_cutoff;
@@ -48,9 +62,25 @@ namespace pdr
     // if true: simply copy what is possible
     bool simple_relax;
 
+    // if true: answer pdr's queries with the embedded cdcl solver instead of z3
+    bool cdcl;
+
+    // set by a portfolio run. once it holds, the run stops by throwing
+    // Interrupted
+    std::atomic<bool> const* interrupt{ nullptr };
+    // set by a portfolio run that shares lemmas between its instances
+    LemmaChannel* lemmas{ nullptr };
+
+    // the number of threads that check cubes in the propagation phase
+    uint32_t propagation_threads;
+    // if set: the directory where blocked cubes are kept between runs
+    std::optional<my::io::fs::path> lemma_cache;
+
     Context(z3::context& c, my::cli::ArgumentList const& args);
     // override seed value
     Context(z3::context& c, my::cli::ArgumentList const& args, unsigned s);
+    // the same settings for another z3 context
+    Context(z3::context& c, Context const& settings);
 
     operator z3::context&();
     operator const z3::context&() const;
@@ -58,9 +88,17 @@ namespace pdr
     z3::context& operator()();
 
     std::string settings_str() const;
+    bool interrupted() const;
 
    private:
     void init_settings(my::cli::ArgumentList const& args);
   }; // class PDRcontext
+
+  // thrown by a run that is stopped through Context::interrupt
+  class Interrupted : public std::runtime_error
+  {
+   public:
+    Interrupted() : std::runtime_error("pdr run interrupted") {}
+  };
 } // namespace pdr
 #endif // PDRCONTEXT_H
@@ -38,6 +38,9 @@ namespace pdr
     const z3::expr_vector& get_initial() const;
     const z3::expr_vector& get_transition() const;
     const z3::expr_vector& get_constraint() const;
+    // literals that are assumed in every query. a model can keep the clauses
+    // of its constraint fixed and select a bound among them through these
+    const z3::expr_vector& get_constraint_assumptions() const;
     virtual const z3::expr get_constraint_current() const = 0;
 
     // load horn-clause representation into a z3::fixedpoint engine.
@@ -50,6 +53,18 @@ namespace pdr
     virtual z3::func_decl& fp_query_ref();
     virtual PdrResult::Trace::TraceVec fp_trace_states(z3::fixedpoint& engine);
 
+    // reduce "pred", a predecessor of the state "succ", to the literals that
+    // force a transition into "succ" for every state they describe. the
+    // result is a subset of pred in its order. the default keeps all
+    virtual std::vector<z3::expr> lift(std::vector<z3::expr> const& pred,
+        std::vector<z3::expr> const& succ) const;
+    // the images of "cube" under the symmetries of the system: permutations
+    // of the state that map the initial states, transition, constraint and
+    // property onto themselves. an image is reachable in k steps iff cube is.
+    // without "cube" itself or duplicates. the default has none
+    virtual std::vector<std::vector<z3::expr>> symmetric(
+        std::vector<z3::expr> const& cube) const;
+
     // the number of literals that encode a state of the system
     virtual unsigned state_size() const              = 0;
     // brief string to describe the meaning of the present constraint
@@ -65,6 +80,7 @@ namespace pdr
     z3::expr_vector initial;
     z3::expr_vector transition; // vector of clauses (cnf)
     z3::expr_vector constraint; // vector of clauses (cnf)
+    z3::expr_vector constraint_assumptions; // vector of literals
 
     // fixedpoint engine interface
     //
@@ -4,6 +4,7 @@
 #include <memory>
 #include <optional>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include <z3++.h>
 
@@ -43,6 +44,10 @@ namespace pdr::pebbling
     std::optional<unsigned> get_pebble_constraint() const;
 
     const z3::expr get_constraint_current() const override;
+    // ternary simulation of the step from pred to succ: a literal is dropped
+    // if every node stays or may flip regardless of its value
+    std::vector<z3::expr> lift(std::vector<z3::expr> const& pred,
+        std::vector<z3::expr> const& succ) const override;
     unsigned state_size() const override;
     // return string representation of the constraint
     const std::string constraint_str() const override;
@@ -59,6 +64,18 @@ namespace pdr::pebbling
     unsigned final_pebbles;
     // maximum number of pebbled nodes allowed per state
     std::optional<unsigned> pebble_constraint;
+    // totalizer outputs over the current and next state: count[j] holds if
+    // at least j+1 nodes are pebbled. their clauses are the constraint. the
+    // bound is selected by assuming !count[k] and !count_p[k].
+    // empty until a bound below n_nodes() is set
+    std::vector<z3::expr> count;
+    std::vector<z3::expr> count_p;
+
+    // the structure of the dag by variable index, for lift()
+    std::vector<std::vector<size_t>> child_nodes;
+    std::vector<std::vector<size_t>> parent_nodes;
+    // id() of a current or next variable -> its index
+    std::unordered_map<unsigned, size_t> node_index;
 
     // cnf formula: expanded the original implication into conjunction of clauses
     void load_pebble_transition(const dag::Graph& G);
@@ -69,6 +86,10 @@ namespace pdr::pebbling
     // non-cnf formula: one implication per parent
     void load_pebble_transition_raw2(const dag::Graph& G);
     void load_property(const dag::Graph& G);
+    // (re)build the totalizers with at least "cap" outputs. a larger cap only
+    // adds clauses and outputs, the existing outputs keep their meaning
+    void load_pebble_counters(size_t cap);
+    void load_structure(const dag::Graph& G);
   };
 } // namespace pdr::pebbling
 
@@ -50,6 +50,8 @@ namespace pdr::peterson
 
     // the maximum amount of switches that can be tracked
     static constexpr size_t SWITCH_COUNT_MAX = 31; // 5 bits
+    // symmetric() stops after this many images. blocking fewer is still sound
+    static constexpr size_t SYMMETRY_MAX_IMAGES = 720; // 6!
 
     // enum Internals
     // {
@@ -96,6 +98,14 @@ namespace pdr::peterson
     unsigned n_processes() const;
     std::optional<unsigned> get_switch_bound() const;
 
+    // the processes 1 .. p-1 are interchangeable: an image renames their pc
+    // and level, and the process ids held by last and proc_last. process 0
+    // is not, the initial last[] hold its id. the processes p .. N-1 never
+    // fire. a cube that fixes only some bits of a last or proc_last has no
+    // images
+    std::vector<std::vector<z3::expr>> symmetric(
+        std::vector<z3::expr> const& cube) const override;
+
     // Configure IModel
     void constrain_switches(std::optional<numrep_t> m);
 
@@ -108,6 +118,12 @@ namespace pdr::peterson
     void test_wait(numrep_t i);
     void test_property();
     void test_p_pred();
+    // explores the states reachable in at most "steps" transitions and checks
+    // that the images of each one under symmetric() are reached at the same
+    // step. check_symmetry runs it for 3 and 4 processes, see
+    // --check-symmetry
+    bool test_symmetry(unsigned steps);
+    static bool check_symmetry(z3::context& c, unsigned steps = 8);
 
    private:
     // inherited from IModel
@@ -149,6 +165,12 @@ namespace pdr::peterson
     // alternatively viewed as a sign bit for l
     // std::vector<Lit> free;
 
+    // indexes the bits of all variables above. the owner index of each
+    // variable in the table, filled by mk_vars()
+    mysat::primed::SymbolTable symbols;
+    std::vector<unsigned> pc_sym, level_sym, last_sym;
+    unsigned proc_last_sym, switch_count_sym;
+
     size_t n_lits() const;
 
     // fill the pc, level, free and last variables
@@ -0,0 +1,160 @@
+#ifndef CDCL_H
+#define CDCL_H
+
+#include <atomic>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+// a small incremental cdcl sat solver in the style of minisat.
+// two watched literals, vsids with phase saving, 1uip learning, luby restarts.
+// supports solving under assumptions with a core of failed assumptions and
+// push/pop of clause scopes.
+namespace mysat::cdcl
+{
+  using var_t = uint32_t;
+  using lit_t = uint32_t; // 2 * var + sign. sign 1 is negative
+
+  inline lit_t mk_lit(var_t v, bool negative = false) { return 2 * v + negative; }
+  inline lit_t negate(lit_t l) { return l ^ 1; }
+  inline var_t var(lit_t l) { return l >> 1; }
+  inline bool sign(lit_t l) { return l & 1; }
+
+  enum class lbool : uint8_t
+  {
+    True,
+    False,
+    Undef
+  };
+
+  class Solver
+  {
+   public:
+    struct Stats
+    {
+      uint64_t solves{ 0 };
+      uint64_t conflicts{ 0 };
+      uint64_t decisions{ 0 };
+      uint64_t propagations{ 0 };
+      uint64_t restarts{ 0 };
+    };
+    Stats stats;
+
+    Solver(uint32_t seed = 0);
+
+    var_t new_var();
+    size_t n_vars() const;
+    // number of clauses added by the user in all active scopes
+    size_t n_clauses() const;
+    size_t n_learnts() const;
+
+    // add a clause to the current scope. it is removed again by pop()
+    void add_clause(std::vector<lit_t> const& lits);
+    // add a clause that remains when scopes are popped (definitions of
+    // auxiliary variables)
+    void add_permanent(std::vector<lit_t> const& lits);
+
+    void push();
+    // remove the last n scopes and all clauses learned since
+    void pop(unsigned n = 1);
+    unsigned n_scopes() const;
+
+    // @post: if true, model_value() is available. if false, failed() is
+    // available
+    bool solve(std::vector<lit_t> const& assumptions = {});
+    lbool model_value(var_t v) const;
+    bool model_true(lit_t l) const;
+    // the subset of assumptions that were used to derive unsatisfiability
+    std::vector<lit_t> const& failed() const;
+
+    // solve() gives up between restarts once flag holds
+    void set_interrupt(std::atomic<bool> const* flag);
+    // true if the last solve() gave up without an answer
+    bool interrupted() const;
+
+   private:
+    using cref_t                  = uint32_t;
+    static constexpr cref_t NONE  = UINT32_MAX;
+    static constexpr lit_t UNDEF  = UINT32_MAX;
+
+    struct Clause
+    {
+      std::vector<lit_t> lits;
+      bool learnt;
+      bool deleted;
+      double activity;
+    };
+
+    struct Watcher
+    {
+      cref_t cref;
+      lit_t blocker;
+    };
+
+    bool ok{ true };
+    std::mt19937 rng;
+    std::atomic<bool> const* interrupt{ nullptr };
+    bool gave_up{ false };
+
+    // clause database
+    std::vector<std::vector<lit_t>> permanent;
+    std::vector<std::vector<lit_t>> originals;
+    std::vector<size_t> scope_marks;
+    std::vector<Clause> clauses;
+    std::vector<cref_t> learnts;
+    size_t n_deleted{ 0 };
+    std::vector<std::vector<Watcher>> watches; // lit -> clauses watching it
+
+    // assignment
+    std::vector<lbool> assigns;
+    std::vector<int> level;
+    std::vector<cref_t> reason;
+    std::vector<bool> polarity;
+    std::vector<lit_t> trail;
+    std::vector<size_t> trail_lim;
+    size_t qhead{ 0 };
+
+    // vsids
+    std::vector<double> activity;
+    double var_inc{ 1.0 };
+    double cla_inc{ 1.0 };
+    std::vector<var_t> heap;
+    std::vector<int> heap_index; // -1 if not in heap
+    double max_learnts{ 0 };
+
+    std::vector<lit_t> assumptions;
+    std::vector<lbool> model;
+    std::vector<lit_t> conflict;
+    std::vector<char> seen;
+
+    lbool value(lit_t l) const;
+    unsigned decision_level() const;
+    void new_decision_level();
+    void enqueue(lit_t l, cref_t from);
+    void cancel_until(unsigned lvl);
+
+    void attach(std::vector<lit_t> lits, bool learnt);
+    void rebuild();
+    void collect_garbage();
+
+    cref_t propagate();
+    void analyze(cref_t confl, std::vector<lit_t>& out, unsigned& bt_level);
+    bool redundant(lit_t l) const;
+    void analyze_final(lit_t p);
+    lbool search(int n_conflicts);
+    lit_t pick_branch();
+    void reduce_db();
+    bool locked(cref_t c) const;
+
+    void bump_var(var_t v);
+    void bump_clause(Clause& c);
+    void decay();
+
+    bool heap_less(var_t a, var_t b) const;
+    void heap_insert(var_t v);
+    var_t heap_pop();
+    void heap_up(size_t i);
+    void heap_down(size_t i);
+  };
+} // namespace mysat::cdcl
+#endif // CDCL_H
@@ -0,0 +1,60 @@
+#ifndef TSEYTIN_H
+#define TSEYTIN_H
+
+#include <optional>
+#include <unordered_map>
+#include <vector>
+#include <z3++.h>
+
+// plaisted-greenbaum encoding of boolean formulas into clauses, without
+// z3's tactics. a subformula gets a fresh literal that is defined only in the
+// direction in which it occurs. subformulas are shared by their z3 ast id, so
+// a gate that occurs many times is encoded once.
+// non-boolean structure (theory atoms, uninterpreted functions) is kept as an
+// atom
+namespace z3ext::tseytin
+{
+  class Encoder
+  {
+   public:
+    Encoder(z3::context& c);
+
+    // assert "e": append clauses that hold iff e holds, for some value of the
+    // fresh literals
+    void add(z3::expr const& e);
+    // all clauses added so far
+    z3::expr_vector const& clauses() const;
+
+   private:
+    // the directions in which a literal is defined
+    enum polarity : unsigned
+    {
+      POS  = 1, // lit => formula
+      NEG  = 2, // formula => lit
+      BOTH = POS | NEG
+    };
+
+    struct Gate
+    {
+      z3::expr node; // keeps the ast, and so its id, alive
+      std::optional<z3::expr> lit;
+      unsigned defined{ 0 };
+    };
+
+    z3::context& ctx;
+    z3::expr_vector cnf;
+    std::unordered_map<unsigned, Gate> gates;
+
+    void assert_(z3::expr const& e, bool sign);
+    // a literal for "e", defined in the directions of "mask"
+    z3::expr lit(z3::expr const& e, unsigned mask);
+    void define(Gate& g, unsigned mask);
+    void define_junction(Gate& g, unsigned mask, bool is_and);
+    void define_xor(Gate& g, unsigned mask, bool is_xor);
+    void define_ite(Gate& g, unsigned mask);
+    z3::expr fresh();
+    void clause(std::vector<z3::expr> const& lits);
+  };
+} // namespace z3ext::tseytin
+
+#endif // TSEYTIN_H
@@ -65,10 +65,14 @@ namespace pdr
       return (std::string(2 * indent, ' ') + "| ").append(msg);
     }
 
+    // only the logger with the default name becomes spdlog's default logger
     Logger(const std::string& log_file,
-        std::optional<std::string_view> pfilename, OutLvl l, Statistics&& s);
+        std::optional<std::string_view> pfilename,
+        OutLvl l,
+        Statistics&& s,
+        const std::string& name = "pdr_logger");
 
-    void init(const std::string& log_file);
+    void init(const std::string& log_file, const std::string& name);
 
     // LOGGING OUTPUT
     //
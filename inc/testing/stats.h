@@ -78,7 +78,14 @@ namespace pdr
     Average generalization_reduction;
     Average mic_attempts;
     unsigned mic_limit{ 0u };
+    Statistic ctg_blocked; // per level a ctg is blocked at
+    unsigned ctg_levels{ 0u }; // levels switched to ctg by ctg-adaptive mic
     Statistic subsumed_cubes;
+    Statistic symmetric_cubes; // per level an image of a blocked cube is at
+    Statistic symmetric_queries; // per level, solver calls to check images
+    Statistic inductive_cache_hits;   // per level of the inductive query
+    Statistic inductive_cache_misses; // per level of the inductive query
+    Average lift_reduction; // fraction of a predecessor dropped by lifting
 
     double relax_copied_cubes_perc;
     std::vector<size_t> pre_relax_F;
@@ -95,6 +102,8 @@ namespace pdr
     void is_pebbling(dag::Graph const& G);
     // set the statistics header to describe a DAG model for pebbling
     void is_peter(unsigned p, unsigned N);
+    // set the statistics header to describe an aiger model
+    void is_aiger(size_t inputs, size_t latches, size_t ands);
 
     // update the current and maximum processes in the peterson header
     void update_peter(unsigned p, unsigned N);
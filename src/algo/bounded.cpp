@@ -8,7 +8,6 @@
 #include "z3-ext.h"
 #include <algorithm>
 #include <cassert>
-#include <regex>
 #include <tabulate/table.hpp>
 #include <z3++.h>
 
@@ -25,8 +24,8 @@ namespace bounded
       : context(),
         graph(G),
         solver(context),
-        lit_names(),
-        n_lits(G.nodes.size())
+        lit_names(G.nodes()),
+        n_lits(G.n_nodes())
   {
     using namespace my::io;
 
@@ -35,9 +34,6 @@ namespace bounded
     solver.set("sat.cardinality.solver", true);
     solver.set("cardinality.solver", true);
     // solver.set("sat.random_seed", ctx.seed);
-    for (string_view s : G.nodes)
-      lit_names.emplace_back(s);
-    std::sort(lit_names.begin(), lit_names.end());
 
     result_out = args.folders.file_in_run("trace");
   }
@@ -47,6 +43,7 @@ namespace bounded
     solver.reset();
     current_bound = {};
     cardinality   = {};
+    counters.clear();
   }
 
   expr BoundedPebbling::lit(std::string_view name, size_t time_step)
@@ -55,52 +52,68 @@ namespace bounded
     return context.bool_const(full_name.c_str());
   }
 
-  expr BoundedPebbling::constraint(const expr_vector& lits)
+  expr_vector BoundedPebbling::bound(size_t length)
   {
-    return z3::atmost(lits, cardinality.value());
+    size_t k = cardinality.value();
+    expr_vector rv(context);
+    if (k >= n_lits) // the bound is trivial, there is nothing to count
+      return rv;
+
+    for (size_t t = 1; t <= length; t++)
+    {
+      // count up to k+1 at t. a larger count has the same output names and
+      // a superset of the clauses, so it replaces a smaller one
+      if (counters.at(t).size() <= k)
+      {
+        expr_vector lits(context), cnf(context);
+        for (string_view n : lit_names)
+          lits.push_back(lit(n, t));
+        counters[t] = z3ext::tseytin::add_totalizer(
+            cnf, fmt::format("_count{}_", t), lits, k + 1);
+        solver.add(cnf);
+      }
+      rv.push_back(!counters[t][k]);
+    }
+    return rv;
   }
 
-  ConstrainedExpr BoundedPebbling::initial()
+  expr BoundedPebbling::initial()
   {
-    expr_vector cube(context), lits(context);
+    expr_vector cube(context);
     for (string_view n : lit_names)
-    {
-      expr l = lit(n, 0);
-      lits.push_back(l);
-      cube.push_back(!l);
-    }
+      cube.push_back(!lit(n, 0));
 
-    return { z3::mk_and(cube), constraint(lits) };
+    return z3::mk_and(cube);
   }
 
-  ConstrainedExpr BoundedPebbling::final()
+  expr BoundedPebbling::final(size_t length)
   {
-    expr_vector cube(context), lits(context);
-    for (string_view n : lit_names)
+    expr_vector cube(context);
+    for (dag::node_t i = 0; i < graph.n_nodes(); i++)
     {
-      expr l = lit(n, current_bound.value());
-      lits.push_back(l);
-      if (graph.is_output(n))
+      expr l = lit(graph.name_of(i), length);
+      if (graph.is_output(i))
         cube.push_back(l);
       else
         cube.push_back(!l);
     }
 
-    return { z3::mk_and(cube), constraint(lits) };
+    return z3::mk_and(cube);
   }
 
-  ConstrainedExpr BoundedPebbling::trans_step(size_t i)
+  expr BoundedPebbling::trans_step(size_t i)
   {
-    expr_vector next(context), T(context);
-    for (std::string_view node : lit_names) // every node has a transition
+    expr_vector T(context);
+    // every node has a transition
+    for (dag::node_t n = 0; n < graph.n_nodes(); n++)
     {
-      expr source   = lit(node, i);
-      expr source_p = lit(node, i + 1);
-      next.push_back(source_p);
+      expr source   = lit(graph.name_of(n), i);
+      expr source_p = lit(graph.name_of(n), i + 1);
       // pebble if all children are pebbled now and next
       // or unpebble if all children are pebbled now and next
-      for (std::string_view child : graph.get_children(node))
+      for (dag::node_t c : graph.children(n))
       {
+        std::string_view child = graph.name_of(c);
         // clang-format off
         T.push_back( source || !source_p || lit(child, i));
         T.push_back(!source ||  source_p || lit(child, i));
@@ -110,14 +123,18 @@ namespace bounded
       }
     }
 
-    return { z3::mk_and(T), constraint(next) };
+    return z3::mk_and(T);
   }
 
   z3::check_result BoundedPebbling::check(size_t steps, double allowance)
   {
     push_transitions(steps);
     context.set("timeout", (int)(allowance * 1000.0));
-    z3::check_result result = solver.check(final());
+    // steps beyond `steps` may already be unrolled for a previous
+    // cardinality. they are left unconstrained
+    expr_vector assumptions = bound(steps);
+    assumptions.push_back(final(steps));
+    z3::check_result result = solver.check(assumptions);
     // assert(result != z3::check_result::unknown);
 
     return result;
@@ -128,14 +145,17 @@ namespace bounded
     assert(steps > 0);
     if (!current_bound)
     {
-      ConstrainedExpr I = initial();
-      solver.add(I.expression);
-      solver.add(I.constraint);
+      solver.add(initial());
+      counters.emplace_back();
       current_bound = 0;
     }
 
+    // the counters are built by bound(), once the cardinality needs them
     for (size_t& i = current_bound.value(); i < steps; i++)
+    {
       solver.add(trans_step(i));
+      counters.emplace_back();
+    }
   }
 
   pdr::pebbling::IpdrPebblingResult BoundedPebbling::run()
@@ -143,12 +163,13 @@ namespace bounded
     using fmt::format;
     using std::endl;
 
-    std::vector<std::string> names(graph.nodes.cbegin(), graph.nodes.cend());
+    std::vector<std::string> const& names = graph.nodes();
     pdr::pebbling::IpdrPebblingResult total(
-        names, names, graph.output.size(), pdr::Tactic::constrain);
+        names, names, graph.n_outputs(), pdr::Tactic::constrain);
 
-    size_t pebbles = graph.nodes.size();
+    size_t pebbles = graph.n_nodes();
     bool done  = false;
+    reset();
     trace      = {};
     total_time = 0.0;
     sub_times.resize(0);
@@ -157,12 +178,13 @@ namespace bounded
     std::cout << "start BMC" << std::endl;
 
     // constrain down to optimum
-    while (!done && pebbles >= graph.output.size())
+    while (!done && pebbles >= graph.n_outputs())
     {
       card_timer.reset();
 
       auto elapsed = [this]() { return card_timer.elapsed().count(); };
 
+      assert(!cardinality || pebbles < *cardinality);
       cardinality = pebbles;
 
       //
@@ -182,7 +204,8 @@ namespace bounded
           auto r = pdr::PdrResult::found_trace(get_trace(length))
                        .with_duration(elapsed());
           total.add(r, cardinality);
-          reset();
+          // the unrolled steps are kept, the next cardinality only changes
+          // the assumptions
           break;
         }
 
@@ -209,35 +232,6 @@ namespace bounded
     return total;
   }
 
-  // get the name, mark and timestep of m[i]
-  Marking get_time_step(const z3::model& m, size_t i)
-  {
-    assert(i < m.num_consts());
-    Marking rv;
-    {
-      // matches the [name].[timestep] format
-      std::regex postfix(R"(^([[:alnum:]_]+).([[:digit:]]+)$)");
-      std::smatch postfix_match;
-      std::string lit_str{ m[i]().to_string() };
-      if (!std::regex_match(lit_str, postfix_match, postfix))
-      {
-        assert(false);
-      }
-      assert(postfix_match.size() == 3);
-
-      rv.name            = postfix_match[1];
-      string postfix_str = postfix_match[2];
-      sscanf(postfix_str.c_str(), "%zu", &rv.timestep);
-    }
-    {
-      z3::expr assignment = m.get_const_interp(m[i]);
-      assert(assignment.is_bool());
-      rv.mark = assignment.is_true();
-    }
-
-    return rv;
-  }
-
   std::string BoundedPebbling::strategy_table(
       const vector<TraceRow>& content) const
   {
@@ -264,7 +258,7 @@ namespace bounded
     return ss.str();
   }
 
-  BoundedPebbling::TraceVec BoundedPebbling::get_trace(size_t length) const
+  BoundedPebbling::TraceVec BoundedPebbling::get_trace(size_t length)
   {
     TraceVec rv;
 
@@ -272,18 +266,15 @@ namespace bounded
     rv.clear();
     rv.resize(length + 1);
 
-    for (size_t i = 0; i < witness.size(); i++)
+    // the model also assigns counters and steps beyond length. lit_names is
+    // sorted, so every state is as well
+    for (size_t t = 0; t <= length; t++)
     {
-      Marking lit = get_time_step(witness, i);
-      assert(lit.timestep < length + 1);
-      rv.at(lit.timestep).push_back(z3ext::LitStr(lit.name, lit.mark));
-    }
-
-    for (TraceState& s : rv)
-    {
-      std::sort(s.begin(), s.end(),
-          [](z3ext::LitStr const& a, z3ext::LitStr const& b)
-          { return a.name < b.name; });
+      for (string const& name : lit_names)
+      {
+        expr value = witness.eval(lit(name, t), true);
+        rv[t].push_back(z3ext::LitStr(name, value.is_true()));
+      }
     }
 
     return rv;
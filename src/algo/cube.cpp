@@ -0,0 +1,242 @@
+#include "cube.h"
+#include "z3-ext.h"
+
+#include <cassert>
+#include <fmt/core.h>
+#include <stdexcept>
+
+namespace pdr
+{
+  using std::optional;
+  using std::string;
+  using std::vector;
+  using z3::expr;
+  using z3::expr_vector;
+
+  namespace constrained_cube
+  {
+    namespace
+    {
+      struct CLit
+      {
+        optional<size_t> constraint;
+        Cube lits;
+      };
+
+      CLit extract_clit(std::map<lit_t, size_t> const& order, Cube const& c)
+      {
+        CLit rv;
+        rv.lits.reserve(c.size());
+        for (lit_t l : c)
+        {
+          auto found = order.find(l);
+          if (found != order.end()) // clit found
+          {
+            if (rv.constraint)
+              throw std::runtime_error("cube contains multiple clits");
+            rv.constraint = found->second;
+          }
+          else
+            rv.lits.push_back(l);
+        }
+        return rv;
+      }
+    } // namespace
+
+    Cube mk_constrained_cube(
+        std::map<lit_t, size_t> const& order, Cube cube, lit_t constraint)
+    {
+      assert(std::is_sorted(cube.begin(), cube.end()));
+      size_t size = order.at(constraint);
+
+      // see if a clit from order is present
+      for (auto it = cube.begin(); it != cube.end(); it++)
+      {
+        auto found = order.find(*it);
+        if (found != order.end()) // clit found
+        {
+          if (size < found->second) // tightest constraint holds
+          {
+            cube.erase(it); // replace old
+            break;
+          }
+          else
+            return cube; // keep old lits
+        }
+      }
+
+      // insert constraint and maintain sorted order
+      cube.insert(
+          std::lower_bound(cube.begin(), cube.end(), constraint), constraint);
+
+      return cube;
+    }
+
+    bool subsumes_l(
+        std::map<lit_t, size_t> const& order, Cube const& a, Cube const& b)
+    {
+      CLit alits = extract_clit(order, a);
+      CLit blits = extract_clit(order, b);
+
+      // no constraint is always stronger or equal
+      if (!alits.constraint)
+        return pdr::subsumes_l(alits.lits, blits.lits);
+
+      // a has a stronger constraint
+      if (blits.constraint && *alits.constraint > *blits.constraint)
+        return pdr::subsumes_l(alits.lits, blits.lits);
+
+      // constraint b is stronger than constraint a, or b is unconstrained
+      return false; // so b is stronger even if cube subsumes
+    }
+
+    bool subsumes_le(
+        std::map<lit_t, size_t> const& order, Cube const& a, Cube const& b)
+    {
+      CLit alits = extract_clit(order, a);
+      CLit blits = extract_clit(order, b);
+
+      // no constraint is always stronger or equal
+      if (!alits.constraint)
+        return pdr::subsumes_le(alits.lits, blits.lits);
+
+      // a has a stronger constraint
+      if (blits.constraint && *alits.constraint >= *blits.constraint)
+        return pdr::subsumes_le(alits.lits, blits.lits);
+
+      // constraint b is stronger than constraint a, or b is unconstrained
+      return false; // so b is stronger even if cube subsumes
+    }
+  } // namespace constrained_cube
+
+  // LitTable members
+  //
+  LitTable::LitTable(mysat::primed::VarVec const& v)
+      : vars(v), atoms(v.get_ctx()), atoms_p(v.get_ctx())
+  {
+    for (size_t i{ 0 }; i < vars().size(); i++)
+      add_atom(vars(i));
+  }
+
+  uint32_t LitTable::add_atom(expr const& a)
+  {
+    assert(a.is_const());
+    uint32_t i = atoms.size();
+    atoms.push_back(a);
+    atoms_p.push_back(vars.p(a));
+    index.emplace(a.id(), i);
+
+    return i;
+  }
+
+  lit_t LitTable::operator()(expr const& l)
+  {
+    bool neg = l.is_not();
+    expr a   = neg ? l.arg(0) : l;
+
+    auto found = index.find(a.id());
+    if (found != index.end())
+      return mk_lit(found->second, neg);
+
+    if (!a.is_const() || !a.is_bool())
+      throw std::invalid_argument(
+          fmt::format("LitTable: {} is not a literal", l.to_string()));
+
+    return mk_lit(add_atom(a), neg);
+  }
+
+  Cube LitTable::operator()(vector<expr> const& lits)
+  {
+    Cube rv;
+    rv.reserve(lits.size());
+    for (expr const& l : lits)
+      rv.push_back(operator()(l));
+    std::sort(rv.begin(), rv.end());
+
+    return rv;
+  }
+
+  Cube LitTable::operator()(expr_vector const& lits)
+  {
+    Cube rv;
+    rv.reserve(lits.size());
+    for (expr const& l : lits)
+      rv.push_back(operator()(l));
+    std::sort(rv.begin(), rv.end());
+
+    return rv;
+  }
+
+  expr LitTable::operator()(lit_t l) const
+  {
+    assert(atom(l) < atoms.size());
+    expr a = atoms[atom(l)];
+    return negated(l) ? !a : a;
+  }
+
+  expr LitTable::p(lit_t l) const
+  {
+    assert(atom(l) < atoms_p.size());
+    expr a = atoms_p[atom(l)];
+    return negated(l) ? !a : a;
+  }
+
+  vector<expr> LitTable::to_vec(Cube const& c) const
+  {
+    vector<expr> rv;
+    rv.reserve(c.size());
+    for (lit_t l : c)
+      rv.push_back(operator()(l));
+
+    return rv;
+  }
+
+  expr_vector LitTable::to_expr_vec(Cube const& c) const
+  {
+    expr_vector rv(atoms.ctx());
+    for (lit_t l : c)
+      rv.push_back(operator()(l));
+
+    return rv;
+  }
+
+  expr_vector LitTable::p(Cube const& c) const
+  {
+    expr_vector rv(atoms.ctx());
+    for (lit_t l : c)
+      rv.push_back(p(l));
+
+    return rv;
+  }
+
+  // negate cube via demorgan
+  expr LitTable::clause(Cube const& c) const
+  {
+    expr_vector rv(atoms.ctx());
+    for (lit_t l : c)
+      rv.push_back(operator()(l ^ 1));
+
+    return z3::mk_or(rv);
+  }
+
+  size_t LitTable::size() const { return atoms.size(); }
+
+  bool LitTable::portable(CubeView c) const
+  {
+    size_t n = vars().size(); // registered first
+    return std::all_of(
+        c.begin(), c.end(), [n](lit_t l) { return atom(l) < n; });
+  }
+
+  string LitTable::to_string(CubeView c, string const& delimiter) const
+  {
+    string rv;
+    for (size_t i{ 0 }; i < c.size(); i++)
+    {
+      if (i > 0)
+        rv += delimiter;
+      rv += operator()(c[i]).to_string();
+    }
+    return rv;
+  }
+} // namespace pdr
@@ -6,6 +6,7 @@
 #include <algorithm>
 #include <cassert>
 #include <chrono>
+#include <cstdint>
 #include <fmt/core.h>
 #include <memory>
 #include <numeric>
@@ -21,116 +22,285 @@ namespace pdr
 
   Frame::Frame(unsigned i) : level(i) {}
 
-  void Frame::clear() { blocked_cubes.clear(); }
+  void Frame::clear()
+  {
+    arena.clear();
+    entries.clear();
+    blocked_cubes.clear();
+    occurs.clear();
+    watches.clear();
+    empty_cubes.clear();
+    garbage = 0;
+  }
+
+  uint64_t Frame::signature(CubeView c)
+  {
+    uint64_t sig{ 0 };
+    for (lit_t l : c)
+      sig |= uint64_t(1) << (l & 63);
+    return sig;
+  }
 
-  bool Frame::is_subsumed(vector<expr> const& new_cube) const
+  CubeView Frame::view(Entry const& e) const
   {
-    for (vector<expr> const& blocked_cube : blocked_cubes)
+    lit_t const* begin = arena.data() + e.offset;
+    return CubeView(begin, begin + e.size);
+  }
+
+  CubeView Frame::view(uint32_t id) const { return view(entries[id]); }
+
+  lit_t Frame::rarest(CubeView cube) const
+  {
+    assert(cube.size() > 0);
+    lit_t best        = cube[0];
+    size_t best_count = SIZE_MAX;
+    for (lit_t l : cube)
     {
-      if (z3ext::subsumes_le(blocked_cube, new_cube))
+      size_t count = l < occurs.size() ? occurs[l].size() : 0;
+      if (count < best_count)
       {
-        return true; // equal or stronger clause found
+        best       = l;
+        best_count = count;
+      }
+    }
+    return best;
+  }
+
+  void Frame::index(uint32_t id)
+  {
+    CubeView c = view(id);
+    if (c.size() == 0)
+    {
+      empty_cubes.push_back(id);
+      return;
+    }
+
+    lit_t max = c[c.size() - 1]; // sorted
+    if (max >= occurs.size())
+    {
+      occurs.resize(max + 1);
+      watches.resize(max + 1);
+    }
+    watches[rarest(c)].push_back(id);
+    for (lit_t l : c)
+      occurs[l].push_back(id);
+  }
+
+  void Frame::insert(Cube const& cube)
+  {
+    uint32_t id = entries.size();
+    entries.push_back({ static_cast<uint32_t>(arena.size()),
+        static_cast<uint32_t>(cube.size()), signature(cube),
+        static_cast<uint32_t>(blocked_cubes.size()) });
+    arena.insert(arena.end(), cube.begin(), cube.end());
+    blocked_cubes.push_back(id);
+    index(id);
+  }
+
+  void Frame::erase(uint32_t id)
+  {
+    Entry& e = entries[id];
+    assert(e.position != REMOVED);
+    garbage += e.size;
+
+    uint32_t last             = blocked_cubes.back();
+    blocked_cubes[e.position] = last;
+    entries[last].position    = e.position;
+    blocked_cubes.pop_back();
+    e.position = REMOVED;
+  }
+
+  void Frame::compact()
+  {
+    size_t removed = entries.size() - blocked_cubes.size();
+    if (removed == 0 ||
+        (garbage < arena.size() / 2 && removed < blocked_cubes.size()))
+      return;
+
+    vector<lit_t> old_arena = std::move(arena);
+    vector<Entry> old_entries = std::move(entries);
+    arena.clear();
+    arena.reserve(old_arena.size() - garbage);
+    entries.clear();
+    entries.reserve(blocked_cubes.size());
+    for (auto& o : occurs)
+      o.clear();
+    for (auto& w : watches)
+      w.clear();
+    empty_cubes.clear();
+
+    // ids are renumbered to their position
+    for (uint32_t i{ 0 }; i < blocked_cubes.size(); i++)
+    {
+      Entry const& e = old_entries[blocked_cubes[i]];
+      entries.push_back(
+          { static_cast<uint32_t>(arena.size()), e.size, e.signature, i });
+      arena.insert(arena.end(), old_arena.begin() + e.offset,
+          old_arena.begin() + e.offset + e.size);
+      blocked_cubes[i] = i;
+      index(i);
+    }
+    garbage = 0;
+  }
+
+  // a blocked cube that subsumes new_cube has all its literals in new_cube, so
+  // it is found in the watch list of one of them
+  bool Frame::is_subsumed(Cube const& new_cube) const
+  {
+    for (uint32_t id : empty_cubes)
+      if (entries[id].position != REMOVED)
+        return true;
+
+    uint64_t sig = signature(new_cube);
+    for (lit_t l : new_cube)
+    {
+      if (l >= watches.size())
+        continue;
+      for (uint32_t id : watches[l])
+      {
+        Entry const& e = entries[id];
+        if (e.position == REMOVED || (e.signature & ~sig) != 0)
+          continue;
+        if (subsumes_le(view(e), new_cube))
+          return true; // equal or stronger clause found
       }
     }
     return false;
   }
 
-  unsigned Frame::remove_subsumed(const vector<expr>& cube, bool remove_equal)
+  // every cube that is subsumed by cube contains its rarest literal
+  unsigned Frame::remove_subsumed(Cube const& cube, bool remove_equal)
   {
     unsigned before = blocked_cubes.size();
 
-    auto subsumes = [remove_equal](const vector<expr>& l, const vector<expr>& r)
+    if (cube.empty())
     {
-      return remove_equal ? z3ext::subsumes_le(l, r) : z3ext::subsumes_l(l, r);
-    };
-
-    for (auto it = blocked_cubes.begin(); it != blocked_cubes.end();)
+      for (size_t i = 0; i < blocked_cubes.size();)
+      {
+        if (remove_equal || view(blocked_cubes[i]).size() > 0)
+          erase(blocked_cubes[i]); // i now holds the last cube
+        else
+          i++;
+      }
+    }
+    else
     {
-      if (subsumes(cube, *it))
-        it = blocked_cubes.erase(it);
-      else
-        it++;
+      lit_t key = rarest(cube);
+      if (key < occurs.size())
+      {
+        uint64_t sig = signature(cube);
+        // erase() leaves the index lists untouched
+        for (uint32_t id : occurs[key])
+        {
+          Entry const& e = entries[id];
+          if (e.position == REMOVED || (sig & ~e.signature) != 0)
+            continue;
+
+          CubeView blocked = view(e);
+          if (remove_equal ? subsumes_le(cube, blocked)
+                           : subsumes_l(cube, blocked))
+            erase(id);
+        }
+      }
     }
+    compact();
+
     return before - blocked_cubes.size();
   }
 
   unsigned Frame::remove_subsumed_constrained(
-      std::map<unsigned, size_t> const& order,
-      const std::vector<z3::expr>& cube,
-      bool remove_equal)
+      std::map<lit_t, size_t> const& order, Cube const& cube, bool remove_equal)
   {
-    using z3ext::constrained_cube::subsumes_l;
-    using z3ext::constrained_cube::subsumes_le;
+    using constrained_cube::subsumes_l;
+    using constrained_cube::subsumes_le;
 
     unsigned before = blocked_cubes.size();
 
-    auto subsumes = [remove_equal, &order](
-                        const vector<expr>& l, const vector<expr>& r) {
-      return remove_equal ? subsumes_le(order, l, r) : subsumes_l(order, l, r);
-    };
-
-    for (auto it = blocked_cubes.begin(); it != blocked_cubes.end();)
+    for (size_t i = 0; i < blocked_cubes.size();)
     {
-      if (subsumes(cube, *it))
-        it = blocked_cubes.erase(it);
+      Cube blocked = view(blocked_cubes[i]).to_cube();
+      if (remove_equal ? subsumes_le(order, cube, blocked)
+                       : subsumes_l(order, cube, blocked))
+        erase(blocked_cubes[i]);
       else
-        it++;
+        i++;
     }
+    compact();
+
     return before - blocked_cubes.size();
   }
 
   // interface
   //
-  // cube is sorted by id()
-  // block cube unless it, or a stronger version, is already blocked
-  // TODO redundant, make void or make useful
-  bool Frame::block(vector<expr> const& cube)
+  // cube is sorted
+  // block cube unless it is already blocked
+  bool Frame::block(Cube const& cube)
   {
-    return blocked_cubes.insert(cube).second;
+    assert(std::is_sorted(cube.begin(), cube.end()));
+    if (cube.empty())
+    {
+      for (uint32_t id : empty_cubes)
+        if (entries[id].position != REMOVED)
+          return false;
+    }
+    else if (cube[0] < occurs.size())
+    {
+      uint64_t sig = signature(cube);
+      for (uint32_t id : occurs[cube[0]])
+      {
+        Entry const& e = entries[id];
+        if (e.position != REMOVED && e.signature == sig &&
+            equal_cubes(view(e), cube))
+          return false;
+      }
+    }
+
+    insert(cube);
+    return true;
   }
 
-  // assumes vectors in 'blocked_cubes' are sorted
   bool Frame::equals(const Frame& f) const
   {
     if (this->blocked_cubes.size() != f.blocked_cubes.size())
       return false;
 
-    auto l_cube = this->blocked_cubes.begin();
-    auto r_cube = f.blocked_cubes.begin();
-    auto l_end  = this->blocked_cubes.end();
-    auto r_end  = f.blocked_cubes.end();
-    for (; l_cube != l_end && r_cube != r_end; l_cube++, r_cube++)
-    {
-      // if l_cubes* != r_cubes* -> return false
-      if (l_cube->size() != r_cube->size())
-        return false;
-
-      auto l_lit = l_cube->begin();
-      auto r_lit = r_cube->begin();
-      for (; l_lit != l_cube->end() && r_lit != r_cube->end(); l_lit++, r_lit++)
-        if ((*l_lit).id() != (*r_lit).id())
-          return false;
-    }
-    return true;
+    return get() == f.get();
   }
 
-  std::vector<vector<expr>> Frame::diff(const Frame& f) const
+  std::vector<Cube> Frame::diff(const Frame& f) const
   {
-    vector<vector<expr>> out;
-    std::set_difference(blocked_cubes.begin(), blocked_cubes.end(),
-        f.blocked_cubes.begin(), f.blocked_cubes.end(), std::back_inserter(out),
-        z3ext::std_expr_vector_less());
+    CubeSet l = get(), r = f.get();
+
+    vector<Cube> out;
+    std::set_difference(
+        l.begin(), l.end(), r.begin(), r.end(), std::back_inserter(out));
     return out;
   }
 
-  const z3ext::CubeSet& Frame::get() const { return blocked_cubes; }
+  CubeSet Frame::get() const
+  {
+    CubeSet rv;
+    for (uint32_t id : blocked_cubes)
+      rv.insert(view(id).to_cube());
+
+    return rv;
+  }
+
+  size_t Frame::size() const { return blocked_cubes.size(); }
+
+  CubeView Frame::operator[](size_t i) const
+  {
+    assert(i < blocked_cubes.size());
+    return view(blocked_cubes[i]);
+  }
+
   bool Frame::empty() const { return blocked_cubes.size() == 0; }
 
-  std::string Frame::blocked_str() const
+  std::string Frame::blocked_str(LitTable const& lits) const
   {
     std::string str(fmt::format("blocked cubes in frame {}\n", level));
-    for (vector<expr> const& e : blocked_cubes)
-      str += fmt::format("- {}\n", z3ext::join_ev(e, " & "));
+    for (Cube const& c : get())
+      str += fmt::format("- {}\n", lits.to_string(c, " & "));
 
     return str;
   }
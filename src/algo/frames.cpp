@@ -1,5 +1,6 @@
 #include "frames.h"
 #include "frame.h"
+#include "lemma-exchange.h"
 #include "logger.h"
 #include "solver.h"
 #include "stats.h"
@@ -32,6 +33,7 @@ namespace pdr
 
   Frames::Frames(Context c, IModel& m, Logger& l)
       : init_solver(c),
+        lits(m.vars),
         ctx(c),
         model(m),
         log(l),
@@ -49,6 +51,9 @@ namespace pdr
 
     init_frames();
 
+    if (ctx.propagation_threads > 1)
+      pool = std::make_unique<PropagationPool>(ctx, ctx.propagation_threads);
+
     MYLOG_DEBUG(log, "FI_solver after init {}", FI_solver.as_str("", false));
     MYLOG_DEBUG(log, "solver after init {}", delta_solver.as_str("", false));
   }
@@ -75,6 +80,7 @@ namespace pdr
     frames.clear();
     act.clear();
     detached_frontier = {};
+    inductive_answers.clear();
 
     init_frames();
 
@@ -88,6 +94,7 @@ namespace pdr
   {
     assert(frames.size() == act.size());
 
+    inductive_answers.clear();
     // pop until given index is the highest
     while (frontier() > frontier_index)
     {
@@ -101,8 +108,7 @@ namespace pdr
     size_t n_pre = delta_solver.n_clauses;
 
     delta_solver.reset();
-    for (size_t i = 1; i < frames.size(); i++)
-      delta_solver.block(frames[i].get(), act.at(i));
+    block_all();
 
     MYLOG_DEBUG(log, "Repopulated solver: reduced from {} to {} clauses.",
         n_pre, delta_solver.n_clauses);
@@ -117,16 +123,18 @@ namespace pdr
     MYLOG_INFO(log, "Copy frames to new sequence: {{ F_1 }}");
 
     // reconstrain solver and reset it to "no blocked"
+    FI_solver.reconstrain_clear(model.get_constraint());
     delta_solver.reconstrain_clear(model.get_constraint());
-    z3ext::CubeSet old = get_blocked_in(1); // store all cubes in F_1
-    clear_until(0);                         // reset sequence to { F_0 }
+    inductive_answers.clear();
+    CubeSet old = get_blocked_in(1); // store all cubes in F_1
+    clear_until(0);                  // reset sequence to { F_0 }
     detached_frontier = {};
     extend(); // reinstate level 1
 
     unsigned count = 0;
-    for (vector<expr> const& cube : old)
+    for (Cube const& cube : old)
     {
-      if (SAT(0, z3ext::convert(cube)))
+      if (SAT(0, lits.to_expr_vec(cube)))
       {
 #warning todo/future work regeneralize cti from this cube (must be possible or counter)
         // TODO regeneralize cti from this cube (must be possible or counter)
@@ -155,15 +163,17 @@ namespace pdr
         frames.size() - 1);
 
     // reconstrain solver and reset it to "no blocked"
+    FI_solver.reconstrain_clear(model.get_constraint());
     delta_solver.reconstrain_clear(model.get_constraint());
+    inductive_answers.clear();
 
     // aggregate level at which each cube was learned
     size_t learned_lvls = 0u;
     size_t copied_lvls  = 0u;
     for (size_t i{ 1 }; i < frames.size(); i++)
-      learned_lvls += i * frames[i].get().size();
+      learned_lvls += i * frames[i].size();
 
-    z3ext::CubeSet old = get_blocked_in(1); // all previously learned cubes
+    CubeSet old = get_blocked_in(1); // all previously learned cubes
 
     // repopulate every level
     for (size_t i{ 0 }; i < frames.size() - 1; i++)
@@ -180,7 +190,8 @@ namespace pdr
         }
         else
         {
-          MYLOG_DEBUG(log, "copied up to level {}: [{}]", i, join_ev(*cube_it));
+          MYLOG_DEBUG(
+              log, "copied up to level {}: [{}]", i, lits.to_string(*cube_it));
           copied_lvls += i;
           cube_it = old.erase(cube_it); // cannot be inductive to higher levels
         }
@@ -190,7 +201,7 @@ namespace pdr
       log.stats.relax_copied_cubes_perc =
           (double)copied_lvls / learned_lvls * 100.0;
     });
-    repopulate_solvers();
+    refresh_solver_if_clogged();
 
     detached_frontier = 1;
 
@@ -200,7 +211,7 @@ namespace pdr
   void Frames::copy_to_Fk_keep(
       size_t old_step, expr_vector const& old_constraint)
   {
-    using namespace z3ext::constrained_cube;
+    using constrained_cube::mk_constrained_cube;
 
     assert(frames.size() > 0);
     assert(model.diff == IModel::Diff_t::relaxed);
@@ -211,18 +222,21 @@ namespace pdr
         frames.size() - 1);
 
     new_constraint(old_step, old_constraint);
+    lit_t clit = lits(clits.at(old_step));
 
     // put all definitions into solver
     expr_vector base = z3ext::vec_add(model.property(), old_constraints());
+    FI_solver.reconstrain_clear(model.get_constraint());
     delta_solver.remake(base, model.get_transition(), model.get_constraint());
+    inductive_answers.clear();
 
     // aggregate level at which each cube was learned
     size_t learned_lvls = 0u, copied_lvls = 0u;
     for (size_t i{ 1 }; i < frames.size(); i++)
-      learned_lvls += i * frames[i].get().size();
+      learned_lvls += i * frames[i].size();
 
-    z3ext::CubeSet old = get_blocked_in(1); // all previously learned cubes
-    vector<z3ext::CubeSet> old_frames;
+    CubeSet old = get_blocked_in(1); // all previously learned cubes
+    vector<CubeSet> old_frames;
     for (Frame& f : frames)
     {
       old_frames.push_back(f.get());
@@ -240,9 +254,9 @@ namespace pdr
     for (size_t i{ 1 }; i < old_frames.size(); i++)
     {
       IF_STATS(log.stats.pre_relax_F.at(i) = old_frames[i].size(););
-      for (vector<expr> const& cube : old_frames[i])
+      for (Cube const& cube : old_frames[i])
         remove_state(
-            mk_constrained_cube(clit_ids, cube, old_step), i); // at least true
+            mk_constrained_cube(clit_codes, cube, clit), i); // at least true
     }
     MYLOG_DEBUG(log, blocked_str());
 
@@ -262,7 +276,8 @@ namespace pdr
         }
         else
         {
-          MYLOG_DEBUG(log, "copied up to level {}: [{}]", i, join_ev(*cube_it));
+          MYLOG_DEBUG(
+              log, "copied up to level {}: [{}]", i, lits.to_string(*cube_it));
           IF_STATS(log.stats.post_relax_F.at(i)++;);
           copied_lvls += i;
           cube_it = old.erase(cube_it); // cannot be inductive to higher levels
@@ -273,23 +288,44 @@ namespace pdr
       log.stats.relax_copied_cubes_perc =
           learned_lvls > 0 ? (double)copied_lvls / learned_lvls * 100.0 : 0.0;
     });
-    repopulate_solvers();
+    refresh_solver_if_clogged();
     MYLOG_DEBUG(log, blocked_str());
 
     detached_frontier = 1;
     model.diff        = IModel::Diff_t::none;
   }
 
+  Frames::Snapshot Frames::snapshot() const
+  {
+    return { learned(), frames.size(), detached_frontier };
+  }
+
+  void Frames::restore(Snapshot const& s)
+  {
+    assert(s.n_frames >= 2);
+    reset();
+    while (frames.size() < s.n_frames)
+      new_frame();
+
+    for (Lemma const& l : s.cubes)
+      import_state(l.cube, l.level);
+
+    detached_frontier = s.detached_frontier;
+    MYLOG_INFO(log, "Restored {} cubes in < F_1 ... F_{} >", s.cubes.size(),
+        frames.size() - 1);
+  }
+
   optional<size_t> Frames::reuse()
   {
     assert(frames.size() > 0);
     assert(model.diff == IModel::Diff_t::constrained);
 
-    delta_solver.reconstrain_clear(model.get_constraint());
-
-    // repopulate
-    for (size_t i{ 1 }; i < frames.size(); i++)
-      delta_solver.block(frames[i].get(), act.at(i));
+    // the tighter constraint implies the old one, so every blocked cube stays
+    // valid and the solver does not need to be repopulated. the initial
+    // solver blocks nothing
+    FI_solver.reconstrain_clear(model.get_constraint());
+    delta_solver.reconstrain_tighten(model.get_constraint());
+    inductive_answers.clear();
 
     // with fewer transitions, new cubes may be propagated
     MYLOG_INFO(log, "Redoing last propagation: {}", frontier() - 1);
@@ -300,20 +336,70 @@ namespace pdr
 
   // state removal functions
   //
-  bool Frames::remove_state(std::vector<expr> const& cube, size_t level)
+  bool Frames::remove_state(Cube const& cube, size_t level)
   {
     assert(level < frames.size());
     // level = std::min(level, frames.size() - 1);
-    MYLOG_DEBUG(
-        log, "removing cube from level [1..{}]: [{}]", level, join_ev(cube));
+    MYLOG_DEBUG(log, "removing cube from level [1..{}]: [{}]", level,
+        lits.to_string(cube));
 
     log.indent++;
     bool result = delta_remove_state(cube, level);
     log.indent--;
+
+    if (result && ctx.lemmas && lits.portable(cube))
+      ctx.lemmas->publish(cube, level);
+
     return result;
   }
 
-  bool Frames::delta_remove_state(std::vector<expr> const& cube, size_t level)
+  void Frames::remove_symmetric(Cube const& cube, size_t level)
+  {
+    // an image is only as good as the symmetry the model claims. block it
+    // once it is inductive relative to the frames, like a shared lemma
+    size_t queries{ 0 };
+    for (vector<expr> const& image : model.symmetric(lits.to_vec(cube)))
+    {
+      Cube c = lits(image);
+      if (already_blocked(c, level))
+        continue;
+
+      queries++;
+      if (intersects_initial(c))
+        continue;
+
+      if (!inductive_answers.find(c, level - 1))
+        queries++;
+      if (!inductive_cached(c, level - 1).inductive)
+        continue;
+
+      log.indent++;
+      bool blocked = delta_remove_state(c, level);
+      log.indent--;
+      if (!blocked)
+        continue;
+
+      MYLOG_DEBUG(log, "blocked symmetric image: [{}]", lits.to_string(c));
+      IF_STATS(log.stats.symmetric_cubes.add(level));
+      if (ctx.lemmas && lits.portable(c))
+        ctx.lemmas->publish(c, level);
+    }
+    IF_STATS(log.stats.symmetric_queries.add(level, queries));
+  }
+
+  bool Frames::import_state(Cube const& cube, size_t level)
+  {
+    assert(level < frames.size());
+    MYLOG_DEBUG(log, "importing cube to level [1..{}]: [{}]", level,
+        lits.to_string(cube));
+
+    log.indent++;
+    bool result = delta_remove_state(cube, level);
+    log.indent--;
+    return result;
+  }
+
+  bool Frames::delta_remove_state(Cube const& cube, size_t level)
   {
     for (unsigned i = 1; i <= level; i++)
     {
@@ -330,7 +416,8 @@ namespace pdr
 
     if (frames[level].block(cube))
     {
-      delta_solver.block(cube, act.at(level));
+      delta_solver.block(lits.to_expr_vec(cube), act.at(level));
+      inductive_answers.blocked(level);
       MYLOG_DEBUG(log, "blocked in {}", level);
       return true;
     }
@@ -341,13 +428,12 @@ namespace pdr
 
   // constrained state removal functions
   //
-  bool Frames::remove_state_constrained(
-      std::vector<expr> const& cube, size_t level)
+  bool Frames::remove_state_constrained(Cube const& cube, size_t level)
   {
     assert(level < frames.size());
     // level = std::min(level, frames.size() - 1);
     MYLOG_DEBUG(log, "removing constrained cube from level [1..{}]: [{}]",
-        level, join_ev(cube));
+        level, lits.to_string(cube));
 
     log.indent++;
     bool result = delta_remove_state_constrained(cube, level);
@@ -355,15 +441,14 @@ namespace pdr
     return result;
   }
 
-  bool Frames::delta_remove_state_constrained(
-      std::vector<expr> const& cube, size_t level)
+  bool Frames::delta_remove_state_constrained(Cube const& cube, size_t level)
   {
     for (unsigned i = 1; i <= level; i++)
     {
       // remove all blocked cubes that are equal or weaker than cube
       // in the last level, we can leave an equal cube in
       unsigned n_removed =
-          frames.at(i).remove_subsumed_constrained(clit_ids, cube, i < level);
+          frames.at(i).remove_subsumed_constrained(clit_codes, cube, i < level);
       delta_solver.n_subsumed += n_removed;
       MYLOG_DEBUG(
           log, "cube subsumes {} cubes in level {}. removed.", n_removed, i);
@@ -374,7 +459,8 @@ namespace pdr
 
     if (frames[level].block(cube))
     {
-      delta_solver.block(cube, act.at(level));
+      delta_solver.block(lits.to_expr_vec(cube), act.at(level));
+      inductive_answers.blocked(level);
       MYLOG_DEBUG(log, "blocked in {}", level);
       return true;
     }
@@ -394,8 +480,24 @@ namespace pdr
     log.indent++;
     bool repeat = (k < frontier());
 
+    size_t n_cubes{ 0 };
     for (size_t i = 1; i <= k; i++)
-      push_forward_delta(i, repeat);
+      n_cubes += frames.at(i).size();
+
+    if (ctx.interrupted())
+      throw Interrupted();
+
+    // handing out queries only pays off if every worker gets a few
+    if (pool && n_cubes >= 4 * pool->size())
+    {
+      for (size_t i = 1; i <= k; i++)
+        push_forward_parallel(i, repeat);
+    }
+    else
+    {
+      for (size_t i = 1; i <= k; i++)
+        push_forward_delta(i, repeat);
+    }
 
     MYLOG_DEBUG(log, "after propagation {}", blocked_str());
 
@@ -406,7 +508,7 @@ namespace pdr
         return i;
       }
 
-    repopulate_solvers();
+    refresh_solver_if_clogged();
     log.indent--;
 
     return {};
@@ -417,10 +519,13 @@ namespace pdr
     using std::chrono::steady_clock;
     auto start = steady_clock::now();
 
-    unsigned count         = 0;
-    z3ext::CubeSet blocked = frames.at(level).get();
-    for (std::vector<expr> const& cube : blocked)
+    unsigned count  = 0;
+    CubeSet blocked = frames.at(level).get();
+    for (Cube const& cube : blocked)
     {
+      if (ctx.interrupted())
+        throw Interrupted();
+
       if (!trans_source(level, cube))
       {
         if (remove_state(cube, level + 1))
@@ -435,6 +540,53 @@ namespace pdr
     IF_STATS(log.stats.propagation_level.add(level, dt.count()));
   }
 
+  // a cube that is pushed to level+1 was already in F_level. so the queries of
+  // one level are independent and can be answered in any order
+  void Frames::push_forward_parallel(size_t level, bool repeat)
+  {
+    using std::chrono::steady_clock;
+    auto start = steady_clock::now();
+
+    unsigned count  = 0;
+    CubeSet blocked = frames.at(level).get();
+    vector<expr_vector> dest_p;
+    dest_p.reserve(blocked.size());
+    for (Cube const& cube : blocked)
+    {
+      dest_p.push_back(lits.p(cube));
+      for (expr const& a : model.get_constraint_assumptions())
+        dest_p.back().push_back(a);
+    }
+
+    if (ctx.interrupted())
+      throw Interrupted();
+    pool->sync(delta_solver.assertions(), delta_solver.generation, act);
+    vector<bool> reachable = pool->trans_source(level, dest_p);
+
+    // merge in the order of the serial version
+    size_t j{ 0 };
+    for (Cube const& cube : blocked)
+    {
+      if (!reachable[j++])
+      {
+        if (remove_state(cube, level + 1))
+          if (repeat)
+            count++;
+      }
+    }
+    if (repeat)
+      MYLOG_TRACE(log, "{} blocked in repeat", count);
+
+    std::chrono::duration<double> dt(steady_clock::now() - start);
+    IF_STATS(log.stats.propagation_level.add(level, dt.count()));
+  }
+
+  void Frames::interrupt()
+  {
+    if (pool)
+      pool->interrupt();
+  }
+
   // Raw SAT interface
   //
   bool Frames::SAT(size_t frame, z3::expr_vector const& assumptions)
@@ -446,8 +598,6 @@ namespace pdr
   // and should be considered unusable afterwards
   bool Frames::SAT(size_t frame, z3::expr_vector&& assumptions)
   {
-    // refresh_solver_if_clogged();
-
     using std::chrono::steady_clock;
     auto start = steady_clock::now();
 
@@ -459,6 +609,9 @@ namespace pdr
       for (unsigned i = frame; i < act.size(); i++)
         assumptions.push_back(act[i]);
     }
+    // the bound of a model with a fixed constraint encoding
+    for (expr const& a : model.get_constraint_assumptions())
+      assumptions.push_back(a);
 
     log.indent++;
     MYLOG_TRACE(log, "assumptions: [ {} ]", join_ev(assumptions, false));
@@ -475,42 +628,114 @@ namespace pdr
 
   // queries
   //
+  bool Frames::intersects_initial(Cube const& cube)
+  {
+    expr_vector assumptions = lits.to_expr_vec(cube);
+    z3::check_result result = init_solver.check(assumptions);
+    if (result == z3::unknown && ctx.interrupted())
+      throw Interrupted();
+    return result == z3::sat;
+  }
+
   // verifies if !cube is inductive relative to F_[frame]
   // query: Fi & !cube & T /=> !cube'
-  bool Frames::inductive(std::vector<z3::expr> const& cube, size_t frame)
+  bool Frames::inductive(Cube const& cube, size_t frame)
   {
     MYLOG_TRACE(log, "check relative inductiveness, frame{}", frame);
 
-    z3::expr clause =
-        z3::mk_or(z3ext::negate(cube)); // negate cube via demorgan
-    z3::expr_vector assumptions = model.vars.p(cube); // cube in next state
-    assumptions.push_back(clause);
+    expr_vector assumptions = lits.p(cube); // cube in next state
+    assumptions.push_back(lits.clause(cube));
 
     if (SAT(frame, std::move(assumptions)))
       return false; // there is a transition from !s to s'
     return true;
   }
 
-  std::optional<vector<expr>> Frames::counter_to_inductiveness(
-      std::vector<z3::expr> const& cube, size_t frame)
+  InductiveCache::Answer Frames::inductive_cached(
+      Cube const& cube, size_t frame)
+  {
+    if (optional<InductiveCache::Answer> answer =
+            inductive_answers.find(cube, frame))
+    {
+      IF_STATS(log.stats.inductive_cache_hits.add(frame));
+      return *answer;
+    }
+    IF_STATS(log.stats.inductive_cache_misses.add(frame));
+
+    InductiveCache::Answer answer;
+    answer.inductive = inductive(cube, frame);
+    answer.cube =
+        answer.inductive ? core_current(frame) : witness_current(frame);
+    inductive_answers.store(cube, frame, answer);
+
+    return answer;
+  }
+
+  Cube Frames::core_current(size_t frame)
+  {
+    // extract destination lits and convert to current state literals
+    vector<expr> current;
+    for (expr const& e : get_solver(frame).raw_unsat_core())
+      if (model.vars.lit_is_p(e))
+      {
+        if (z3ext::constrained_cube::is_reserved_lit(e))
+          current.push_back(e);
+        else
+          current.push_back(model.vars(e));
+      }
+    return lits(current);
+  }
+
+  std::optional<Frames::Predecessor> Frames::counter_to_inductiveness(
+      Cube const& cube, size_t frame)
   {
     MYLOG_TRACE(log, "get counter relative inductiveness, frame{}", frame);
 
     if (!inductive(cube, frame))
-      return get_solver(frame).std_witness_current();
+    {
+      if (!ctx.lift)
+        return Predecessor{ witness_current(frame), {}, {} };
+
+      // the lifted cube is only for queries, a trace needs the full states
+      Solver const& solver = get_solver(frame);
+      vector<expr> state   = solver.std_witness_current();
+      vector<expr> next = solver.witness(mysat::primed::lit_type::primed);
+      return Predecessor{ lits(lift(state, next)), lits(state),
+        lits(model.vars(z3ext::convert(next))) };
+    }
 
     return {};
   }
 
-  bool Frames::trans_source(
-      size_t frame, vector<expr> const& dest_cube, bool primed)
+  vector<expr> Frames::lift(vector<expr> const& pred, vector<expr> const& succ)
   {
-    MYLOG_TRACE(log, "check transition source, frame{}", frame);
-    if (!primed) // cube is in current, bring to next
-      return SAT(frame, model.vars.p(dest_cube));
+    if (!ctx.lift)
+      return pred;
+
+    vector<expr> rv = model.lift(pred, succ);
+    // an empty cube would be every state, which is never blocked
+    if (rv.empty())
+      return pred;
+
+    IF_STATS({
+      double reduction = (pred.size() - rv.size()) / (double)pred.size();
+      log.stats.lift_reduction.add(reduction);
+    });
+    MYLOG_TRACE(log, "lifted predecessor from {} to {} literals", pred.size(),
+        rv.size());
+    return rv;
+  }
 
-    // there is a transition from Fi to s'
-    return SAT(frame, z3ext::convert(dest_cube));
+  Cube Frames::witness_current(size_t frame)
+  {
+    return lits(get_solver(frame).std_witness_current());
+  }
+
+  bool Frames::trans_source(size_t frame, Cube const& dest_cube)
+  {
+    MYLOG_TRACE(log, "check transition source, frame{}", frame);
+    // cube is in current, bring to next
+    return SAT(frame, lits.p(dest_cube));
   }
 
   std::optional<Witness> Frames::get_trans_source(
@@ -528,15 +753,14 @@ namespace pdr
     // else there exists a source -T-> dest'
     vector<expr> curr = get_solver(frame).std_witness_current();
     vector<expr> next =
-        get_solver(frame).filter_witness_vector(get_solver(frame).get_model(),
-            [this](const expr l) { return model.vars.lit_is_p(l); });
+        get_solver(frame).witness(mysat::primed::lit_type::primed);
     return Witness(curr, next);
   }
 
   optional<size_t> Frames::already_blocked(
-      vector<expr> const& cube, size_t level) const
+      Cube const& cube, size_t level) const
   {
-    MYLOG_DEBUG(log, "find weaker cube in frames", join_ev(cube));
+    MYLOG_DEBUG(log, "find weaker cube in frames");
     // searching cubes at level = search frames in F[level]...
     for (size_t i = level; i < frames.size(); i++)
     {
@@ -600,23 +824,31 @@ namespace pdr
     return frames[i];
   }
 
-  z3ext::CubeSet Frames::get_blocked_in(size_t i) const
+  CubeSet Frames::get_blocked_in(size_t i) const
   {
     assert(i < frames.size());
-    z3ext::CubeSet blocked;
+    CubeSet blocked;
 
     // in delta encoding, a cube in frames[i] is blocked at levels F_1..F_i
     // to get all bloccked cubes in F_i, gather all in frames[i..]
     for (; i < frames.size(); i++)
-    {
-      // TODO non-const getter allows std::move
-      z3ext::CubeSet const& Fi = frames[i].get();
-      blocked.insert(Fi.begin(), Fi.end());
-    }
+      for (size_t j{ 0 }; j < frames[i].size(); j++)
+        blocked.insert(frames[i][j].to_cube());
 
     return blocked;
   }
 
+  vector<Lemma> Frames::learned() const
+  {
+    vector<Lemma> rv;
+    for (size_t i = 1; i < frames.size(); i++)
+      for (size_t j{ 0 }; j < frames[i].size(); j++)
+        if (lits.portable(frames[i][j]))
+          rv.push_back({ frames[i][j].to_cube(), static_cast<unsigned>(i) });
+
+    return rv;
+  }
+
   // logging and output
   //
   void Frames::log_blocked() const
@@ -641,7 +873,7 @@ namespace pdr
     std::string str = "Frames:\n";
     for (auto& f : frames)
     {
-      str += f.blocked_str();
+      str += f.blocked_str(lits);
       str += '\n';
     }
     return str;
@@ -663,7 +895,7 @@ namespace pdr
 
     constraints.emplace(i, clauses);
     clits.emplace(i, clit);
-    clit_ids.emplace(clit.id(), i);
+    clit_codes.emplace(lits(clit), i);
   }
 
   void Frames::init_frames()
@@ -677,6 +909,14 @@ namespace pdr
     assert(frontier() == 0);
   }
 
+  void Frames::block_all()
+  {
+    for (size_t i = 1; i < frames.size(); i++)
+      for (size_t j{ 0 }; j < frames[i].size(); j++)
+        delta_solver.block(
+            lits.to_expr_vec(frames[i][j].to_cube()), act.at(i));
+  }
+
   void Frames::new_frame()
   {
     std::string acti = fmt::format("_act{}__", frames.size());
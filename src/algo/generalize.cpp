@@ -17,13 +17,12 @@ namespace pdr
   using std::vector;
   using z3::expr;
   using z3::expr_vector;
-  using z3ext::join_ev;
 
   //! s is inductive up until min-1. !s is included up until min
-  PDR::HIFresult PDR::hif_(vector<expr> const& cube, int min)
+  PDR::HIFresult PDR::hif_(Cube const& cube, int min)
   {
     int max = frames.frontier();
-    if (min <= 0 && !frames.inductive(cube, 0))
+    if (min <= 0 && !frames.inductive_cached(cube, 0).inductive)
     {
       MYLOG_DEBUG(logger, "Intersects I");
       return { -1, {} };
@@ -31,48 +30,40 @@ namespace pdr
 
     // F_result & !cube & T & cube' = UNSAT
     // => F_result & !cube & T & core' = UNSAT
-    optional<vector<expr>> raw_core;
+    optional<Cube> core;
 
     int highest = max;
     for (int i = std::max(1, min); i <= max; i++)
     {
       // clause was inductive up to this iteration
-      if (!frames.inductive(cube, i))
+      InductiveCache::Answer answer = frames.inductive_cached(cube, i);
+      if (!answer.inductive)
       {
         highest = i - 1; // previous was greatest inductive frame
         break;
       }
-      raw_core = frames.get_solver(i).raw_unsat_core();
+      core = std::move(answer.cube);
     }
 
     MYLOG_DEBUG(logger, "highest inductive frame is {} / {}", highest,
         frames.frontier());
-    return { highest, raw_core };
+    return { highest, core };
   }
 
-  PDR::HIFresult PDR::highest_inductive_frame(vector<expr> const& cube, int min)
+  PDR::HIFresult PDR::highest_inductive_frame(Cube const& cube, int min)
   {
-    vector<expr> rv_core;
+    Cube rv_core;
     HIFresult result = hif_(cube, min);
 
     if (result.level >= 0 && result.level >= min && result.core)
     { // if unsat result occurs
-      // extract destination lits and convert to current state literals
-      for (expr const& e : *result.core)
-        if (ts.vars.lit_is_p(e))
-        {
-          if (z3ext::constrained_cube::is_reserved_lit(e))
-            rv_core.push_back(e);
-          else
-            rv_core.push_back(ts.vars(e));
-        }
-
-      z3ext::order_lits(rv_core);
+      rv_core = std::move(*result.core);
 
-      MYLOG_DEBUG(logger, "core @{}: [{}]", result.level, join_ev(rv_core));
+      MYLOG_DEBUG(logger, "core @{}: [{}]", result.level,
+          frames.lits.to_string(rv_core));
 
       // if I => !core, the subclause survives initiation and is inductive
-      if (frames.init_solver.check(rv_core.size(), rv_core.data()) == z3::sat)
+      if (frames.intersects_initial(rv_core))
       {
         MYLOG_DEBUG(logger, "unsat core is invalid. no reduction.");
         rv_core = cube; /// I /=> !core, use original
@@ -89,14 +80,14 @@ namespace pdr
       rv_core = cube;
     }
 
-    MYLOG_TRACE(logger, "new cube: [{}]", join_ev(rv_core, false));
+    MYLOG_TRACE(logger, "new cube: [{}]", frames.lits.to_string(rv_core));
     return { result.level, rv_core };
   }
 
-  void PDR::generalize(vector<expr>& state, int level)
+  void PDR::generalize(Cube& state, int level)
   {
     MYLOG_DEBUG(logger, "generalize cube");
-    MYLOG_TRACE(logger, "[{}]", join_ev(state, false));
+    MYLOG_TRACE(logger, "[{}]", frames.lits.to_string(state));
 
     logger.indent++;
     spdlog::stopwatch timer;
@@ -113,19 +104,52 @@ namespace pdr
     logger.indent--;
 
     MYLOG_DEBUG(logger, "generalization: {} -> {}", pre_size, state.size());
-    MYLOG_TRACE(logger, "final reduced cube = [{}]", join_ev(state, false));
+    MYLOG_TRACE(
+        logger, "final reduced cube = [{}]", frames.lits.to_string(state));
   }
 
-// #define ctgmic true
-#define ctgmic false
+// ctg-adaptive: the number of literals plain MIC must have tried on a level
+// before it is judged, and the fraction that must have failed to switch
+#define ADAPTIVE_MIN_ATTEMPTS 32
+#define ADAPTIVE_FAIL_RATE 0.75
+
+  bool PDR::use_ctg(int level)
+  {
+    switch (ctx.mic)
+    {
+      case MicMode::plain: return false;
+      case MicMode::ctg: return true;
+      case MicMode::ctg_adaptive: break;
+    }
+
+    if (level < 0)
+      return false;
+    if (mic_records.size() <= (size_t)level)
+      mic_records.resize(level + 1);
+
+    MicRecord& r = mic_records[level];
+    if (!r.ctg && r.attempts >= ADAPTIVE_MIN_ATTEMPTS &&
+        r.failures >= ADAPTIVE_FAIL_RATE * r.attempts)
+    {
+      r.ctg = true;
+      IF_STATS(logger.stats.ctg_levels++;);
+      MYLOG_DEBUG(logger, "MIC failed {} / {} times on level {}. using ctgs",
+          r.failures, r.attempts, level);
+    }
+    return r.ctg;
+  }
 
-  void PDR::MIC(vector<expr>& cube, int level)
+  void PDR::MIC(Cube& cube, int level)
   {
-    if (ctgmic)
+    if (use_ctg(level))
     {
       MICctg(cube, level, 1);
       return;
     }
+    // only set if the level's outcomes are tracked for ctg-adaptive
+    MicRecord* record = ctx.mic == MicMode::ctg_adaptive && level >= 0
+                          ? &mic_records.at(level)
+                          : nullptr;
 
     assert(level <= (int)frames.frontier());
     // used for sorting
@@ -133,18 +157,19 @@ namespace pdr
     unsigned attempts{ 0u };
     for (unsigned i{ 0 }; i < cube.size();)
     {
-      assert(z3ext::lits_ordered(cube));
-      vector<expr> new_cube(cube.begin(), cube.begin() + i);
+      assert(std::is_sorted(cube.begin(), cube.end()));
+      Cube new_cube(cube.begin(), cube.begin() + i);
       new_cube.reserve(cube.size() - 1);
       new_cube.insert(new_cube.end(), cube.begin() + i + 1, cube.end());
 
-      MYLOG_TRACE(logger, "verifying subcube [{}]", join_ev(new_cube, false));
+      MYLOG_TRACE(
+          logger, "verifying subcube [{}]", frames.lits.to_string(new_cube));
 
       logger.indent++;
       if (down(new_cube, level))
       {
         MYLOG_TRACE(logger, "sub-cube survived down ({} -> {}): [{}]",
-            cube.size(), new_cube.size(), join_ev(new_cube));
+            cube.size(), new_cube.size(), frames.lits.to_string(new_cube));
         // current literal was dropped, i now points to the next literal
         cube = std::move(new_cube);
 #warning try difference between tracking attempts per clause or no. times in a row
@@ -154,10 +179,14 @@ namespace pdr
       {
         MYLOG_TRACE(logger, "sub-cube failed");
         i++;
+        if (record)
+          record->failures++;
       }
       logger.indent--;
 
       attempts++;
+      if (record)
+        record->attempts++;
       if (attempts >= ctx.mic_retries)
       {
         IF_STATS(logger.stats.mic_limit++;);
@@ -169,27 +198,29 @@ namespace pdr
   }
 
   // @state is sorted
-  bool PDR::down(vector<expr>& state, int level)
+  bool PDR::down(Cube& state, int level)
   {
 
     while (true)
     {
-      assert(z3ext::lits_ordered(state));
-      expr* const raw_state = state.data();
-      if (frames.init_solver.check(state.size(), raw_state) == z3::sat)
+      assert(std::is_sorted(state.begin(), state.end()));
+      if (frames.intersects_initial(state))
       {
         MYLOG_TRACE(logger, "state includes I");
         return false;
       }
 
-      if (!frames.inductive(state, level))
+      InductiveCache::Answer answer = frames.inductive_cached(state, level);
+      if (!answer.inductive)
       {
         MYLOG_TRACE(logger, "state is not inductive");
-        logger.indent++;
-        state = frames.get_solver(level).witness_current_intersect(state);
-        logger.indent--;
-        MYLOG_TRACE(
-            logger, "intersection witness and state: [{}]", join_ev(state));
+        Cube const& witness = answer.cube;
+        Cube intersection;
+        std::set_intersection(state.cbegin(), state.cend(), witness.cbegin(),
+            witness.cend(), std::back_inserter(intersection));
+        state = std::move(intersection);
+        MYLOG_TRACE(logger, "intersection witness and state: [{}]",
+            frames.lits.to_string(state));
       }
       else
         return true;
@@ -197,25 +228,26 @@ namespace pdr
     return false;
   }
 
-  void PDR::MICctg(vector<expr>& cube, int level, unsigned depth)
+  void PDR::MICctg(Cube& cube, int level, unsigned depth)
   {
     assert(level <= (int)frames.frontier());
 
     unsigned attempts{ 0u };
     for (unsigned i{ 0 }; i < cube.size();)
     {
-      assert(z3ext::lits_ordered(cube));
-      vector<expr> new_cube(cube.begin(), cube.begin() + i);
+      assert(std::is_sorted(cube.begin(), cube.end()));
+      Cube new_cube(cube.begin(), cube.begin() + i);
       new_cube.reserve(cube.size() - 1);
       new_cube.insert(new_cube.end(), cube.begin() + i + 1, cube.end());
 
-      MYLOG_TRACE(logger, "verifying subcube [{}]", join_ev(new_cube, false));
+      MYLOG_TRACE(
+          logger, "verifying subcube [{}]", frames.lits.to_string(new_cube));
 
       logger.indent++;
       if (ctgdown(new_cube, level, depth))
       {
         MYLOG_TRACE(logger, "sub-cube survived ctg-down ({} -> {}): [{}]",
-            cube.size(), new_cube.size(), join_ev(new_cube));
+            cube.size(), new_cube.size(), frames.lits.to_string(new_cube));
         // current literal was dropped, i now points to the next literal
         cube = std::move(new_cube);
       }
@@ -238,21 +270,21 @@ namespace pdr
   }
 
   // @state is sorted
-  bool PDR::ctgdown(vector<expr>& state, int level, unsigned depth)
+  bool PDR::ctgdown(Cube& state, int level, unsigned depth)
   {
     unsigned ctgs = 0;
 
     while (true)
     {
-      assert(z3ext::lits_ordered(state));
-      expr* const raw_state = state.data();
-      if (frames.init_solver.check(state.size(), raw_state) == z3::sat)
+      assert(std::is_sorted(state.begin(), state.end()));
+      if (frames.intersects_initial(state))
       {
         MYLOG_TRACE(logger, "state includes I");
         return false;
       }
 
-      if (frames.inductive(state, level))
+      InductiveCache::Answer answer = frames.inductive_cached(state, level);
+      if (answer.inductive)
         return true;
       else
       {
@@ -260,19 +292,20 @@ namespace pdr
         if (depth > ctx.ctg_max_depth)
           return false;
 
-        vector<expr> ctg = frames.get_solver(level).std_witness_current();
-        MYLOG_TRACE(logger, "counter-to-generalization: [{}]", join_ev(ctg));
+        Cube ctg = std::move(answer.cube);
+        MYLOG_TRACE(logger, "counter-to-generalization: [{}]",
+            frames.lits.to_string(ctg));
 
         if (ctgs < ctx.ctg_max_counters && level > 0 &&
-            frames.init_solver.check(ctg.size(), ctg.data()) == z3::unsat &&
-            frames.inductive(ctg, level - 1))
+            !frames.intersects_initial(ctg) &&
+            frames.inductive_cached(ctg, level - 1).inductive)
         {
           ctgs++;
           assert(level >= 0);
           // inductiveness push forward
           size_t i;
           for (i = level; i < frames.frontier(); i++)
-            if (!frames.inductive(ctg, i))
+            if (!frames.inductive_cached(ctg, i).inductive)
               break;
 
           MYLOG_TRACE(logger, "!ctg is inductive relative to F_{}", i - 1);
@@ -281,20 +314,20 @@ namespace pdr
           MICctg(ctg, i - 1, depth + 1);
           logger.indent--;
           frames.remove_state(ctg, i);
+          IF_STATS(logger.stats.ctg_blocked.add(i););
         }
         else
         {
           MYLOG_TRACE(logger, "!ctg is not inductive relative");
           ctgs = 0;
-          vector<expr> new_state;
-          assert(z3ext::lits_ordered(state) && z3ext::lits_ordered(ctg));
+          Cube new_state;
           std::set_intersection(state.cbegin(), state.cend(), ctg.cbegin(),
-              ctg.cend(), std::back_inserter(new_state), z3ext::cube_orderer);
+              ctg.cend(), std::back_inserter(new_state));
 
-          state = new_state;
+          state = std::move(new_state);
 
-          MYLOG_TRACE(
-              logger, "intersection ctg and state: [{}]", join_ev(state));
+          MYLOG_TRACE(logger, "intersection ctg and state: [{}]",
+              frames.lits.to_string(state));
         }
       }
     }
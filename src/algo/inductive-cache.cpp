@@ -0,0 +1,71 @@
+#include "inductive-cache.h"
+
+#include <utility>
+
+namespace pdr
+{
+  size_t CubeHash::operator()(Cube const& c) const
+  {
+    // fnv-1a over the literal codes
+    uint64_t h = 14695981039346656037ull;
+    for (lit_t l : c)
+    {
+      h ^= l;
+      h *= 1099511628211ull;
+    }
+    return h;
+  }
+
+  std::optional<InductiveCache::Answer> InductiveCache::find(
+      Cube const& cube, size_t level) const
+  {
+    if (level >= entries.size())
+      return {};
+
+    auto found = entries[level].find(cube);
+    if (found == entries[level].end())
+      return {};
+
+    Entry const& e = found->second;
+    if (!e.answer.inductive && e.version != versions[level])
+      return {};
+
+    return e.answer;
+  }
+
+  void InductiveCache::store(Cube const& cube, size_t level, Answer answer)
+  {
+    if (level >= entries.size())
+    {
+      entries.resize(level + 1);
+      versions.resize(level + 1, 0);
+    }
+
+    auto& level_entries = entries[level];
+    if (level_entries.size() >= MAX_ENTRIES)
+      level_entries.clear();
+
+    level_entries.insert_or_assign(
+        cube, Entry{ std::move(answer), versions[level] });
+  }
+
+  void InductiveCache::blocked(size_t level)
+  {
+    for (size_t i = 1; i <= level && i < versions.size(); i++)
+      versions[i]++;
+  }
+
+  void InductiveCache::clear()
+  {
+    for (auto& level_entries : entries)
+      level_entries.clear();
+  }
+
+  size_t InductiveCache::size() const
+  {
+    size_t rv{ 0 };
+    for (auto const& level_entries : entries)
+      rv += level_entries.size();
+    return rv;
+  }
+} // namespace pdr
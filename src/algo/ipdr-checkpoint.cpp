@@ -0,0 +1,123 @@
+#include "ipdr-checkpoint.h"
+#include "lemma-store.h"
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <fmt/format.h>
+#include <fstream>
+#include <stdexcept>
+#include <string_view>
+
+namespace pdr::pebbling
+{
+  using my::io::read_raw;
+  using my::io::write_raw;
+  using my::io::fs::path;
+
+  namespace
+  {
+    // file layout, in host byte order:
+    // magic, version, key, control, simple_relax,
+    // no. steps, then per step: constraint, level, time,
+    // no. inc_times, then the times,
+    // no. frames, detached frontier + 1 (0 if none), then the cubes as in
+    // write_lemmas()
+    constexpr std::array<char, 4> MAGIC{ 'I', 'P', 'C', 'P' };
+    constexpr uint32_t VERSION = 1;
+  } // namespace
+
+  std::optional<RelaxCheckpoint> RelaxCheckpoint::load(
+      path const& file, IModel const& model)
+  {
+    std::ifstream in(file.string(), std::ios::binary);
+    if (!in)
+      return {};
+
+    auto damaged = [&file](std::string_view what)
+    {
+      return std::runtime_error(
+          fmt::format("cannot resume from {}: {}", file.string(), what));
+    };
+
+    std::array<char, 4> magic;
+    uint32_t version;
+    uint64_t key;
+    if (!read_raw(in, magic) || magic != MAGIC || !read_raw(in, version) ||
+        version != VERSION)
+      throw damaged("not a checkpoint of this version");
+    if (!read_raw(in, key) || key != model_key(model, false))
+      throw damaged("written for another model");
+
+    RelaxCheckpoint rv;
+    uint64_t n_steps, n_inc, n_frames;
+    uint32_t detached;
+    if (!read_raw(in, rv.control) || !read_raw(in, rv.simple_relax) ||
+        !read_raw(in, n_steps) || n_steps == 0)
+      throw damaged("no steps");
+
+    rv.steps.resize(n_steps);
+    for (Step& s : rv.steps)
+      if (!read_raw(in, s.constraint) || !read_raw(in, s.level) ||
+          !read_raw(in, s.time))
+        throw damaged("incomplete steps");
+
+    if (!read_raw(in, n_inc) || n_inc + 1 != n_steps)
+      throw damaged("incomplete times");
+    rv.inc_times.resize(n_inc);
+    for (double& t : rv.inc_times)
+      if (!read_raw(in, t))
+        throw damaged("incomplete times");
+
+    if (!read_raw(in, n_frames) || n_frames < 2 || !read_raw(in, detached) ||
+        detached > n_frames - 1)
+      throw damaged("invalid frames");
+    rv.frames.n_frames = n_frames;
+    if (detached > 0)
+      rv.frames.detached_frontier = detached - 1;
+
+    std::optional<std::vector<Lemma>> cubes =
+        read_lemmas(in, model.vars().size());
+    if (!cubes)
+      throw damaged("incomplete cubes");
+    for (Lemma const& l : *cubes)
+      if (l.level == 0 || l.level >= n_frames)
+        throw damaged("cube outside of the frames");
+    rv.frames.cubes = std::move(*cubes);
+
+    return rv;
+  }
+
+  void RelaxCheckpoint::save(path const& file, IModel const& model) const
+  {
+    assert(!steps.empty() && inc_times.size() + 1 == steps.size());
+
+    my::io::replace_file(file,
+        [&](std::ostream& out)
+        {
+          write_raw(out, MAGIC);
+          write_raw(out, VERSION);
+          write_raw(out, model_key(model, false));
+          write_raw(out, control);
+          write_raw(out, simple_relax);
+
+          write_raw(out, static_cast<uint64_t>(steps.size()));
+          for (Step const& s : steps)
+          {
+            write_raw(out, s.constraint);
+            write_raw(out, s.level);
+            write_raw(out, s.time);
+          }
+
+          write_raw(out, static_cast<uint64_t>(inc_times.size()));
+          for (double t : inc_times)
+            write_raw(out, t);
+
+          write_raw(out, static_cast<uint64_t>(frames.n_frames));
+          write_raw(out,
+              static_cast<uint32_t>(
+                  frames.detached_frontier ? *frames.detached_frontier + 1 : 0));
+          write_lemmas(out, frames.cubes);
+        });
+  }
+} // namespace pdr::pebbling
@@ -23,7 +23,9 @@ namespace pdr::pebbling
         ts(m),
         starting_pebbles(),
         control_setting(args.control_run),
-        simple_relax(args.simple_relax)
+        simple_relax(args.simple_relax),
+        checkpoint(args.checkpoint),
+        resume(args.resume)
   {
     auto const& peb =
         my::variant::get_cref<my::cli::model_t::Pebbling>(args.model)->get();
@@ -61,16 +63,28 @@ namespace pdr::pebbling
     IpdrPebblingResult total(ts, Tactic::relax);
     // need at least this many pebbles
     unsigned N = starting_pebbles.value_or(ts.get_f_pebbles());
+    pdr::PdrResult invariant = PdrResult::empty_true();
 
-    // initial run, no constraining functionality yet
-    basic_reset(N);
-    pdr::PdrResult invariant = alg->run();
-    total.add(invariant, ts.get_pebble_constraint());
+    progress              = RelaxCheckpoint();
+    progress.control      = control;
+    progress.simple_relax = simple_relax;
+
+    if (optional<unsigned> resumed = resume_relax(total))
+      N = *resumed; // every step of the checkpoint found an invariant
+    else
+    {
+      // initial run, no constraining functionality yet
+      basic_reset(N);
+      invariant = alg->run();
+      total.add(invariant, ts.get_pebble_constraint());
+      save_progress(invariant, {});
+    }
 
     for (N = N + 1; invariant && N <= ts.n_nodes(); N++)
     {
       assert(N > ts.get_pebble_constraint()); // check for overflows
 
+      double inc_time;
       { // timed
         spdlog::stopwatch timer;
         if (control)
@@ -82,14 +96,20 @@ namespace pdr::pebbling
           else
             relax_reset_constrained(N);
         }
-        total.append_inc_time(collect_inc_time(N, timer.elapsed().count()));
+        inc_time = collect_inc_time(N, timer.elapsed().count());
+        total.append_inc_time(inc_time);
       }
 
       invariant = alg->run();
 
       total.add(invariant, ts.get_pebble_constraint());
+      save_progress(invariant, inc_time);
     }
 
+    // the sweep is done, a later resume starts over
+    if (checkpoint)
+      my::io::fs::remove(*checkpoint);
+
     if (N > ts.n_nodes()) // last run did not find a trace
       alg->logger.and_whisper("! No optimum exists.");
     else
@@ -268,6 +288,65 @@ namespace pdr::pebbling
     alg->reset();
   }
 
+  std::optional<unsigned> IPDR::resume_relax(IpdrPebblingResult& total)
+  {
+    if (!resume)
+      return {};
+
+    assert(checkpoint);
+    optional<RelaxCheckpoint> loaded = RelaxCheckpoint::load(*checkpoint, ts);
+    if (!loaded)
+    {
+      alg->logger.and_whisper(
+          "! No checkpoint in {}, starting over.", checkpoint->string());
+      return {};
+    }
+    if (loaded->control != progress.control ||
+        loaded->simple_relax != progress.simple_relax)
+      throw std::invalid_argument(fmt::format(
+          "checkpoint {} was written by another relax setting.",
+          checkpoint->string()));
+
+    auto pdr_alg = std::dynamic_pointer_cast<PDR>(alg);
+    if (!pdr_alg)
+      throw std::runtime_error("checkpoints for PDR only.");
+
+    for (size_t i{ 0 }; i < loaded->steps.size(); i++)
+    {
+      RelaxCheckpoint::Step const& s = loaded->steps[i];
+      if (i > 0)
+        total.append_inc_time(loaded->inc_times[i - 1]);
+      total.add(PdrResult::found_invariant(s.level).with_duration(s.time),
+          s.constraint);
+    }
+
+    unsigned N = loaded->steps.back().constraint;
+    basic_reset(N);
+    pdr_alg->frames.restore(loaded->frames);
+    progress = std::move(*loaded);
+
+    alg->logger.and_whisper("! Resumed from {}: no strategy with {} pebbles.",
+        checkpoint->string(), N);
+    return N;
+  }
+
+  void IPDR::save_progress(PdrResult const& r, std::optional<double> inc_time)
+  {
+    if (!checkpoint || !r)
+      return;
+
+    auto pdr_alg = std::dynamic_pointer_cast<PDR>(alg);
+    if (!pdr_alg)
+      throw std::runtime_error("checkpoints for PDR only.");
+
+    progress.steps.push_back({ ts.get_pebble_constraint().value(),
+        r.invariant().level, r.time });
+    if (inc_time)
+      progress.inc_times.push_back(*inc_time);
+    progress.frames = pdr_alg->frames.snapshot();
+    progress.save(*checkpoint, ts);
+  }
+
   void IPDR::relax_reset(unsigned pebbles)
   {
     using fmt::format;
@@ -286,9 +365,11 @@ namespace pdr::pebbling
     using fmt::format;
 
     unsigned old                   = ts.get_pebble_constraint().value();
-    z3::expr_vector old_constraint = z3ext::copy(ts.get_constraint());
+    z3::expr_vector old_constraint =
+        z3ext::copy(ts.get_constraint_assumptions());
     assert(pebbles > old);
-    assert(old_constraint.size() == 2);
+    // empty if the old bound allowed every node to be pebbled
+    assert(old_constraint.size() <= 2);
 
     alg->logger.and_show("increment from {} -> {} pebbles", old, pebbles);
 
@@ -297,7 +378,7 @@ namespace pdr::pebbling
 
     try
     {
-      auto myalg = dynamic_cast<PDR&>(*alg);
+      PDR& myalg = dynamic_cast<PDR&>(*alg);
       myalg.frames.copy_to_Fk_keep(old, old_constraint);
     }
     catch (...)
@@ -0,0 +1,19 @@
+#include "lemma-exchange.h"
+
+namespace pdr
+{
+  LemmaChannel::LemmaChannel(
+      std::vector<std::unique_ptr<LemmaChannel>> const& all)
+      : peers(all)
+  {
+  }
+
+  void LemmaChannel::publish(Cube const& cube, unsigned level)
+  {
+    for (auto const& p : peers)
+      if (p.get() != this)
+        p->inbox.push({ cube, level });
+  }
+
+  std::optional<Lemma> LemmaChannel::receive() { return inbox.pop(); }
+} // namespace pdr
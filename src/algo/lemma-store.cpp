@@ -0,0 +1,130 @@
+#include "lemma-store.h"
+
+#include <array>
+#include <fmt/format.h>
+#include <fstream>
+#include <string_view>
+
+namespace pdr
+{
+  using my::io::read_raw;
+  using my::io::write_raw;
+  using my::io::fs::path;
+  using std::vector;
+
+  namespace
+  {
+    // file layout, in host byte order:
+    // magic, version, key, then the lemmas as in write_lemmas()
+    constexpr std::array<char, 4> MAGIC{ 'P', 'D', 'R', 'L' };
+    constexpr uint32_t VERSION = 1;
+
+    void fnv1a(uint64_t& h, std::string_view s)
+    {
+      for (char c : s)
+      {
+        h ^= static_cast<unsigned char>(c);
+        h *= 1099511628211ull;
+      }
+      h ^= 0xff; // separate consecutive strings
+      h *= 1099511628211ull;
+    }
+  } // namespace
+
+  uint64_t model_key(IModel const& model, bool constraint)
+  {
+    uint64_t h = 14695981039346656037ull;
+    for (z3::expr const& v : model.vars())
+      fnv1a(h, v.to_string());
+    for (z3::expr const& v : model.vars.p())
+      fnv1a(h, v.to_string());
+    for (z3::expr const& e : model.get_initial())
+      fnv1a(h, e.to_string());
+    for (z3::expr const& e : model.get_transition())
+      fnv1a(h, e.to_string());
+    if (constraint)
+    {
+      for (z3::expr const& e : model.get_constraint())
+        fnv1a(h, e.to_string());
+      for (z3::expr const& e : model.get_constraint_assumptions())
+        fnv1a(h, e.to_string());
+    }
+    return h;
+  }
+
+  // no. lemmas, then per lemma: level, size, literals
+  void write_lemmas(std::ostream& out, vector<Lemma> const& lemmas)
+  {
+    write_raw(out, static_cast<uint64_t>(lemmas.size()));
+    for (Lemma const& l : lemmas)
+    {
+      write_raw(out, static_cast<uint32_t>(l.level));
+      write_raw(out, static_cast<uint32_t>(l.cube.size()));
+      for (lit_t lit : l.cube)
+        write_raw(out, lit);
+    }
+  }
+
+  std::optional<vector<Lemma>> read_lemmas(std::istream& in, size_t n_vars)
+  {
+    uint64_t n;
+    if (!read_raw(in, n))
+      return {};
+
+    vector<Lemma> rv;
+    for (uint64_t i{ 0 }; i < n; i++)
+    {
+      uint32_t level, size;
+      if (!read_raw(in, level) || !read_raw(in, size) || size > n_vars)
+        return {};
+
+      Lemma l{ Cube(size), level };
+      for (lit_t& lit : l.cube)
+        if (!read_raw(in, lit) || atom(lit) >= n_vars)
+          return {};
+      rv.push_back(std::move(l));
+    }
+
+    return rv;
+  }
+
+  LemmaStore::LemmaStore(path const& d, IModel const& m) : dir(d), model(m) {}
+
+  path LemmaStore::file() const { return file(model_key(model, true)); }
+
+  path LemmaStore::file(uint64_t k) const
+  {
+    return dir / fmt::format("{:016x}.lemmas", k);
+  }
+
+  vector<Lemma> LemmaStore::load() const
+  {
+    const uint64_t k = model_key(model, true);
+    std::ifstream in(file(k).string(), std::ios::binary);
+    if (!in)
+      return {};
+
+    std::array<char, 4> magic;
+    uint32_t version;
+    uint64_t stored_key;
+    if (!read_raw(in, magic) || magic != MAGIC || !read_raw(in, version) ||
+        version != VERSION || !read_raw(in, stored_key) || stored_key != k)
+      return {};
+
+    return read_lemmas(in, model.vars().size()).value_or(vector<Lemma>());
+  }
+
+  void LemmaStore::save(vector<Lemma> const& lemmas) const
+  {
+    my::io::fs::create_directories(dir);
+    const uint64_t k = model_key(model, true);
+    my::io::replace_file(file(k),
+        [&](std::ostream& out)
+        {
+          write_raw(out, MAGIC);
+          write_raw(out, VERSION);
+          write_raw(out, k);
+          write_lemmas(out, lemmas);
+        });
+  }
+} // namespace pdr
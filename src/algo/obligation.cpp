@@ -2,60 +2,77 @@
 #include "result.h"
 #include "z3-ext.h"
 #include <algorithm>
+#include <cassert>
 
 namespace pdr
 {
-  using std::shared_ptr;
   using std::string;
   using std::vector;
   using z3::expr;
   using z3::expr_vector;
   using TraceState = PdrResult::Trace::TraceState;
 
-  // STATE MEMBERS
+  // STATE REFERENCE MEMBERS
   //
-  PdrState::PdrState(const vector<expr>& e)
-      : cube(e), prev(shared_ptr<PdrState>())
+  StateRef::StateRef(PdrState* s) : node(s)
   {
+    assert(s && s->pool);
+    node->refs++;
   }
-  PdrState::PdrState(const vector<expr>& e, shared_ptr<PdrState> s)
-      : cube(e), prev(s)
+  StateRef::StateRef(StateRef const& other) : node(other.node)
   {
+    if (node)
+      node->refs++;
   }
-  // move constructors
-  PdrState::PdrState(vector<expr>&& e)
-      : cube(std::move(e)), prev(shared_ptr<PdrState>())
+  StateRef::StateRef(StateRef&& other) noexcept : node(other.node)
   {
+    other.node = nullptr;
   }
-  PdrState::PdrState(vector<expr>&& e, shared_ptr<PdrState> s)
-      : cube(std::move(e)), prev(s)
+  StateRef& StateRef::operator=(StateRef other) noexcept
   {
+    std::swap(node, other.node);
+    return *this;
   }
+  StateRef::~StateRef() { release(); }
 
-  unsigned PdrState::show(TextTable& table) const
+  void StateRef::release()
+  {
+    // iterative, a trace may be too long to unwind recursively
+    PdrState* s = node;
+    node        = nullptr;
+    while (s && --s->refs == 0)
+    {
+      PdrState* next = s->prev.node;
+      s->prev.node   = nullptr;
+      s->pool->recycle(s);
+      s = next;
+    }
+  }
+
+  // STATE MEMBERS
+  //
+  PdrState::PdrState(const Cube& e) : cube(e) {}
+  PdrState::PdrState(Cube&& e) : cube(std::move(e)) {}
+
+  unsigned PdrState::show(TextTable& table, LitTable const& lits) const
   {
     vector<std::tuple<unsigned, string, unsigned>> steps;
 
-    auto count_pebbled = [](const vector<expr>& vec)
+    auto count_pebbled = [](const Cube& c)
     {
       unsigned count = 0;
-      for (const expr& e : vec)
-        if (!e.is_not())
+      for (lit_t l : c)
+        if (!negated(l))
           count++;
 
       return count;
     };
 
-    unsigned i = 1;
-    steps.emplace_back(i, z3ext::join_ev(cube), count_pebbled(cube));
-
-    shared_ptr<PdrState> current = prev;
-    while (current)
+    unsigned i = 0;
+    for (Cube const& s : trace())
     {
       i++;
-      steps.emplace_back(
-          i, z3ext::join_ev(current->cube), count_pebbled(current->cube));
-      current = current->prev;
+      steps.emplace_back(i, lits.to_string(s), count_pebbled(s));
     }
     unsigned i_padding = i / 10 + 1;
 
@@ -70,31 +87,144 @@ namespace pdr
     return i_padding;
   }
 
+  vector<Cube> PdrState::trace() const
+  {
+    // lifted cubes are partial states. every state in a lifted cube steps to
+    // the successor it was lifted against, so the trace follows the
+    // successors of the models instead of the cubes
+    vector<Cube> rv;
+    rv.push_back(witness.empty() ? cube : witness);
+    for (PdrState const* s = this; s->prev; s = s->prev.get())
+      rv.push_back(s->witness_next.empty() ? s->prev->cube : s->witness_next);
+
+    return rv;
+  }
+
+  // POOL MEMBERS
+  //
+  StatePool::~StatePool()
+  {
+    // all references should be gone. unlink any remaining chains so states
+    // are not released into a pool that is being destroyed
+    for (PdrState& s : states)
+      s.prev.node = nullptr;
+  }
+
+  StatePool::StatePool(StatePool&& other)
+      : states(std::move(other.states)),
+        free_states(std::move(other.free_states))
+  {
+    for (PdrState& s : states)
+      s.pool = this;
+  }
+
+  StatePool& StatePool::operator=(StatePool&& other)
+  {
+    // unlinks the states of this pool, see ~StatePool
+    for (PdrState& s : states)
+      s.prev.node = nullptr;
+
+    states      = std::move(other.states);
+    free_states = std::move(other.free_states);
+    for (PdrState& s : states)
+      s.pool = this;
+
+    return *this;
+  }
+
+  StateRef StatePool::make(Cube&& cube) { return make(std::move(cube), {}); }
+
+  StateRef StatePool::make(
+      Cube&& cube, StateRef prev, Cube witness, Cube witness_next)
+  {
+    PdrState* s;
+    if (free_states.empty())
+    {
+      s       = &states.emplace_back(std::move(cube));
+      s->pool = this;
+    }
+    else
+    {
+      s = free_states.back();
+      free_states.pop_back();
+      s->cube = std::move(cube);
+    }
+    assert(s->refs == 0 && !s->prev);
+    s->prev         = std::move(prev);
+    s->witness      = std::move(witness);
+    s->witness_next = std::move(witness_next);
+
+    return StateRef(s);
+  }
+
+  size_t StatePool::capacity() const { return states.size(); }
+  size_t StatePool::n_free() const { return free_states.size(); }
+
+  void StatePool::recycle(PdrState* s)
+  {
+    assert(s->pool == this && s->refs == 0);
+    free_states.push_back(s);
+  }
+
   // OBLIGATION MEMBERS
   //
-  Obligation::Obligation(unsigned k, vector<expr>&& cube, unsigned d)
-      : level(k), state(std::make_shared<PdrState>(std::move(cube))), depth(d)
+  Obligation::Obligation(unsigned k, StateRef s, unsigned d)
+      : level(k), state(std::move(s)), depth(d)
   {
   }
 
-  Obligation::Obligation(unsigned k, const shared_ptr<PdrState>& s, unsigned d)
-      : level(k), state(s), depth(d)
+  namespace
+  {
+    // max-heap comparison that puts the lowest depth on top
+    bool deeper(Obligation const& a, Obligation const& b)
+    {
+      return a.depth > b.depth;
+    }
+  } // namespace
+
+  void ObligationQueue::clear()
+  {
+    for (vector<Obligation>& b : buckets)
+      b.clear();
+    lowest        = 0;
+    n_obligations = 0;
+  }
+
+  bool ObligationQueue::empty() const { return n_obligations == 0; }
+  size_t ObligationQueue::size() const { return n_obligations; }
+
+  void ObligationQueue::push(unsigned level, StateRef state, unsigned depth)
+  {
+    if (level >= buckets.size())
+      buckets.resize(level + 1);
+
+    vector<Obligation>& b = buckets[level];
+    b.emplace_back(level, std::move(state), depth);
+    std::push_heap(b.begin(), b.end(), deeper);
+
+    if (n_obligations == 0 || level < lowest)
+      lowest = level;
+    n_obligations++;
+  }
+
+  Obligation const& ObligationQueue::top() const
   {
+    assert(!empty());
+    return buckets[lowest].front();
   }
 
-  // bool operator<(const Obligation& o) const { return this->level <
-  // o.level; }
-  bool Obligation::operator<(const Obligation& o) const
+  void ObligationQueue::pop()
   {
-    if (this->level < o.level)
-      return true;
-    if (this->level > o.level)
-      return false;
-    if (this->depth < o.depth)
-      return true;
-    if (this->depth > o.depth)
-      return false;
+    assert(!empty());
+    vector<Obligation>& b = buckets[lowest];
+    std::pop_heap(b.begin(), b.end(), deeper);
+    b.pop_back();
+    n_obligations--;
 
-    return z3ext::std_expr_vector_less()(this->state->cube, o.state->cube);
+    if (n_obligations == 0)
+      lowest = 0;
+    else
+      while (buckets[lowest].empty())
+        lowest++;
   }
 } // namespace pdr
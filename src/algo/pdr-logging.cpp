@@ -54,26 +54,30 @@ namespace pdr
     IF_STATS(logger.stats.propagation_it.add(level, time);)
   }
 
-  void vPDR::log_top_obligation(
-      size_t queue_size, unsigned top_level, const std::vector<z3::expr>& top)
+  void vPDR::log_top_obligation(size_t queue_size,
+      unsigned top_level,
+      Cube const& top,
+      LitTable const& lits)
   {
     (void)queue_size; // ignore unused warning when logging is off
     (void)top_level;  // ignore unused warning when logging is off
     (void)top;        // ignore unused warning when logging is off
+    (void)lits;       // ignore unused warning when logging is off
     MYLOG_DEBUG(logger, SEP1);
     MYLOG_DEBUG(logger, "obligations pending: {}", queue_size);
     MYLOG_DEBUG(logger, "top obligation");
     logger.indent++;
-    MYLOG_DEBUG(logger, "{}, [{}]", top_level, join_ev(top));
+    MYLOG_DEBUG(logger, "{}, [{}]", top_level, lits.to_string(top));
     logger.indent--;
   }
 
-  void vPDR::log_pred(const std::vector<z3::expr>& p)
+  void vPDR::log_pred(Cube const& p, LitTable const& lits)
   {
-    (void)p; // ignore unused warning when logging is off
+    (void)p;    // ignore unused warning when logging is off
+    (void)lits; // ignore unused warning when logging is off
     MYLOG_DEBUG(logger, "predecessor:");
     logger.indent++;
-    MYLOG_DEBUG(logger, "[{}]", join_ev(p));
+    MYLOG_DEBUG(logger, "[{}]", lits.to_string(p));
     logger.indent--;
   }
 
@@ -84,7 +88,7 @@ namespace pdr
     MYLOG_DEBUG(logger, "push predecessor to level {}", frame);
   }
 
-  void vPDR::log_finish_state(const std::vector<z3::expr>& s)
+  void vPDR::log_finish_state(Cube const& s)
   {
     (void)s; // ignore unused warning when logging is off
     MYLOG_DEBUG(logger, "finishing state");
@@ -1,5 +1,7 @@
 #include "pdr.h"
 #include "TextTable.h"
+#include "lemma-exchange.h"
+#include "lemma-store.h"
 #include "logger.h"
 #include "pdr-model.h"
 #include "result.h"
@@ -16,6 +18,7 @@
 #include <fstream>
 #include <functional>
 #include <iterator>
+#include <map>
 #include <memory>
 #include <set>
 #include <sstream>
@@ -37,7 +40,11 @@ namespace pdr
   {
   }
 
-  void PDR::reset() { frames.reset(); }
+  void PDR::reset()
+  {
+    frames.reset();
+    mic_records.clear();
+  }
 
   std::optional<size_t> PDR::constrain() 
   {
@@ -64,6 +71,13 @@ namespace pdr
     log_start();
     timer.reset();
 
+    if (ctx.lemma_cache)
+    {
+      stored_lemmas   = LemmaStore(*ctx.lemma_cache, ts).load();
+      stored_frontier = 0;
+      MYLOG_INFO(logger, "{} stored lemmas", stored_lemmas.size());
+    }
+
     if (frames.frontier() == 0)
     {
       logger.indent++;
@@ -97,6 +111,9 @@ namespace pdr
     log_pdr_finish(rv, final_time);
     rv.time = final_time;
 
+    if (ctx.lemma_cache)
+      save_lemmas();
+
     IF_STATS({
       logger.stats.elapsed = final_time;
       logger.stats.write(ts.constraint_str());
@@ -122,14 +139,15 @@ namespace pdr
     if (frames.init_solver.check(ts.n_property))
     {
       MYLOG_INFO(logger, "I =/> P");
-      return PdrResult::found_trace(z3ext::convert(ts.get_initial()));
+      return PdrResult::found_trace(
+          PdrState(frames.lits(ts.get_initial())), frames.lits);
     }
 
     if (frames.SAT(0, ts.n_property.p()))
     { // there is a transitions from I to !P
       MYLOG_INFO(logger, "I & T =/> P'");
-      expr_vector bad_cube = frames.get_solver(0).witness_current();
-      return PdrResult::found_trace(z3ext::convert(bad_cube));
+      Cube bad_cube = frames.witness_current(0);
+      return PdrResult::found_trace(PdrState(std::move(bad_cube)), frames.lits);
     }
 
     frames.extend();
@@ -152,11 +170,17 @@ namespace pdr
       while (optional<Witness> witness =
                  frames.get_trans_source(k, ts.n_property.p_vec(), true))
       {
+        if (ctx.interrupted())
+          throw Interrupted();
+        import_lemmas();
+
         // cti is an F_i state that leads to a violation
         log_cti(witness->curr, k);
 
         // is cti reachable from F_k-1 ?
-        PdrResult res = block(std::move(witness->curr), k - 1);
+        Cube cti = frames.lits(frames.lift(witness->curr, witness->next));
+        PdrResult res =
+            block(std::move(cti), frames.lits(witness->curr), k - 1);
         if (not res)
         {
           res.append_final(z3ext::convert(witness->next));
@@ -166,7 +190,10 @@ namespace pdr
         MYLOG_DEBUG(logger, "");
       }
       MYLOG_INFO(logger, "no more counters at F_{}", k);
+      import_lemmas();
 
+      if (ctx.interrupted())
+        throw Interrupted();
       sub_timer.reset();
 
       optional<size_t> invariant_level = frames.propagate();
@@ -178,7 +205,7 @@ namespace pdr
     }
   }
 
-  PdrResult PDR::block(std::vector<z3::expr>&& cti, unsigned n)
+  PdrResult PDR::block(Cube&& cti, Cube&& cti_state, unsigned n)
   {
     unsigned k = frames.frontier();
     logger.indented("eliminate predecessors");
@@ -187,19 +214,27 @@ namespace pdr
     obligations.clear();
 
     if (n <= k)
-      obligations.emplace(n, std::move(cti), 0);
+    {
+      if (cti == cti_state) // not lifted
+        cti_state.clear();
+      obligations.push(
+          n, states.make(std::move(cti), {}, std::move(cti_state)), 0);
+    }
 
     // forall (n, state) in obligations: !state->cube is inductive
     // relative to F[n-1]
-    while (obligations.size() > 0)
+    while (!obligations.empty())
     {
+      if (ctx.interrupted())
+        throw Interrupted();
+
       sub_timer.reset();
       double elapsed;
       string branch;
 
-      auto [n, state, depth] = *(obligations.begin());
+      auto [n, state, depth] = obligations.top();
       assert(n <= k);
-      log_top_obligation(obligations.size(), n, state->cube);
+      log_top_obligation(obligations.size(), n, state->cube, frames.lits);
 
       // skip obligations for which a stronger cube is already blocked in some
       // frame i
@@ -209,7 +244,7 @@ namespace pdr
         {
           MYLOG_DEBUG(logger, "obligation already blocked at level {}", *i);
           MYLOG_DEBUG(logger, "skipped");
-          obligations.erase(obligations.begin());
+          obligations.pop();
           continue;
         }
         else
@@ -219,16 +254,17 @@ namespace pdr
       }
 
       // !state -> state
-      if (optional<std::vector<z3::expr>> pred_cube =
+      if (optional<Frames::Predecessor> p =
               frames.counter_to_inductiveness(state->cube, n))
       {
-        shared_ptr<PdrState> pred = make_shared<PdrState>(*pred_cube, state);
-        log_pred(pred->cube);
+        StateRef pred = states.make(std::move(p->cube), state,
+            std::move(p->state), std::move(p->next));
+        log_pred(pred->cube, frames.lits);
 
         if (n == 0) // intersects with I
-          return PdrResult::found_trace(pred);
+          return PdrResult::found_trace(*pred, frames.lits);
 
-        obligations.emplace(n - 1, pred, depth + 1);
+        obligations.push(n - 1, std::move(pred), depth + 1);
 
         elapsed = sub_timer.elapsed().count();
         branch  = "(pred)  ";
@@ -242,18 +278,19 @@ namespace pdr
         assert(static_cast<unsigned>(m + 1) > n);
 
         if (m < 0)
-          return PdrResult::found_trace(state);
+          return PdrResult::found_trace(*state, frames.lits);
 
         // !s is inductive to F_m
         generalize(core.value(), m);
-        frames.remove_state(core.value(), m + 1);
-        obligations.erase(obligations.begin());
+        if (frames.remove_state(core.value(), m + 1) && ctx.symmetry)
+          frames.remove_symmetric(core.value(), m + 1);
+        obligations.pop();
 
         if (static_cast<unsigned>(m + 1) <= k)
         {
           // push upwards until inductive relative to F_level
           log_state_push(m + 1);
-          obligations.emplace(m + 1, state, depth);
+          obligations.push(m + 1, std::move(state), depth);
         }
 
         elapsed = sub_timer.elapsed().count();
@@ -267,6 +304,82 @@ namespace pdr
     return PdrResult::empty_true();
   }
 
+  void PDR::import_lemmas()
+  {
+    import_stored_lemmas();
+    if (!ctx.lemmas)
+      return;
+
+    unsigned received{ 0 }, imported{ 0 };
+    while (optional<Lemma> lemma = ctx.lemmas->receive())
+    {
+      received++;
+      // the lemma holds in the frames of its sender, which may be ahead
+      size_t level = std::min<size_t>(lemma->level, frames.frontier() + 1);
+      if (level == 0 || frames.already_blocked(lemma->cube, level))
+        continue;
+
+      if (!frames.intersects_initial(lemma->cube) &&
+          frames.inductive_cached(lemma->cube, level - 1).inductive)
+      {
+        frames.import_state(lemma->cube, level);
+        imported++;
+      }
+    }
+
+    if (received > 0)
+      MYLOG_DEBUG(logger, "imported {} of {} shared lemmas", imported, received);
+  }
+
+  void PDR::import_stored_lemmas()
+  {
+    if (stored_lemmas.empty() || frames.frontier() == stored_frontier)
+      return;
+    stored_frontier = frames.frontier();
+
+    unsigned imported{ 0 };
+    auto pending = stored_lemmas.begin();
+    for (Lemma& lemma : stored_lemmas)
+    {
+      size_t level = std::min<size_t>(lemma.level, frames.frontier() + 1);
+      if (level > 0 && !frames.already_blocked(lemma.cube, level) &&
+          !frames.intersects_initial(lemma.cube) &&
+          frames.inductive_cached(lemma.cube, level - 1).inductive)
+      {
+        frames.import_state(lemma.cube, level);
+        imported++;
+      }
+
+      // retry at the next frontier until the lemma reaches its own level
+      if (level < lemma.level)
+        *pending++ = std::move(lemma);
+    }
+    stored_lemmas.erase(pending, stored_lemmas.end());
+
+    MYLOG_DEBUG(logger, "imported {} stored lemmas, {} pending", imported,
+        stored_lemmas.size());
+  }
+
+  void PDR::save_lemmas()
+  {
+    // the highest level of each cube
+    std::map<Cube, unsigned> levels;
+    for (Lemma const& l : frames.learned())
+      levels[l.cube] = std::max(levels[l.cube], l.level);
+    for (Lemma const& l : stored_lemmas)
+      levels[l.cube] = std::max(levels[l.cube], l.level);
+
+    std::vector<Lemma> lemmas;
+    lemmas.reserve(levels.size());
+    for (auto const& [cube, level] : levels)
+      lemmas.push_back({ cube, level });
+
+    LemmaStore store(*ctx.lemma_cache, ts);
+    store.save(lemmas);
+    MYLOG_INFO(logger, "stored {} lemmas in {}", lemmas.size(),
+        store.file().string());
+  }
+
   void PDR::store_frame_strings()
   {
     using std::endl;
@@ -284,6 +397,12 @@ namespace pdr
     logger.stats.solver_dumps.push_back(ss.str());
   }
 
+  void PDR::interrupt()
+  {
+    vPDR::interrupt();
+    frames.interrupt();
+  }
+
   void PDR::show_solver(std::ostream& out) const // TODO
   {
     for (const std::string& s : logger.stats.solver_dumps)
@@ -0,0 +1,130 @@
+#include "portfolio.h"
+
+#include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <z3++.h>
+
+namespace pdr
+{
+  Portfolio::Portfolio(bool share_lemmas) : share(share_lemmas) {}
+
+  Context Portfolio::configure(Context c, unsigned i)
+  {
+    c.interrupt = &stop;
+    if (share)
+    {
+      while (channels.size() <= i)
+        channels.push_back(std::make_unique<LemmaChannel>(channels));
+      c.lemmas = channels[i].get();
+    }
+
+    if (i == 0)
+      return c; // the settings as given
+
+    c.seed += i;
+    // alternate between cheap and thorough generalization
+    switch (i % 3)
+    {
+      case 1:
+        c.mic_retries      = 3;
+        c.ctg_max_counters = 1;
+        break;
+      case 2:
+        c.mic              = MicMode::ctg;
+        c.ctg_max_depth    = 2;
+        c.ctg_max_counters = 5;
+        break;
+      default: break;
+    }
+    return c;
+  }
+
+  void Portfolio::add(vPDR& instance)
+  {
+    assert(instance.ctx.interrupt == &stop);
+    instances.push_back(&instance);
+  }
+
+  size_t Portfolio::size() const { return instances.size(); }
+
+  Portfolio::Outcome Portfolio::run()
+  {
+    using namespace std::chrono_literals;
+
+    std::mutex m;
+    std::condition_variable cv;
+    std::optional<Outcome> first;
+    std::exception_ptr error;
+    // guarded by m
+    std::vector<char> finished(instances.size(), 0);
+    size_t n_finished{ 0 };
+
+    stop = false;
+    auto race = [&](size_t i)
+    {
+      try
+      {
+        PdrResult r = instances[i]->run();
+
+        std::lock_guard<std::mutex> lock(m);
+        if (!first)
+        {
+          first = Outcome{ i, std::move(r) };
+          stop  = true;
+        }
+      }
+      catch (Interrupted const&)
+      {
+      }
+      catch (...)
+      {
+        // an interrupted z3 call may fail outside of check() as well
+        std::lock_guard<std::mutex> lock(m);
+        if (!stop && !error)
+          error = std::current_exception();
+      }
+
+      std::lock_guard<std::mutex> lock(m);
+      finished[i] = 1;
+      n_finished++;
+      cv.notify_all();
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(instances.size());
+    for (size_t i{ 0 }; i < instances.size(); i++)
+      threads.emplace_back(race, i);
+
+    {
+      // a z3 interrupt only reaches a check that is running, and a loser may
+      // start one before it sees the flag. so keep interrupting until every
+      // loser is out
+      std::unique_lock<std::mutex> lock(m);
+      while (n_finished < instances.size())
+      {
+        if (stop)
+          for (size_t i{ 0 }; i < instances.size(); i++)
+            if (!finished[i])
+              instances[i]->interrupt();
+        cv.wait_for(lock, 5ms);
+      }
+    }
+    for (std::thread& t : threads)
+      t.join();
+
+    if (!first)
+    {
+      if (error)
+        std::rethrow_exception(error);
+      throw std::runtime_error("portfolio finished without a result");
+    }
+
+    return std::move(*first);
+  }
+} // namespace pdr
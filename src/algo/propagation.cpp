@@ -0,0 +1,121 @@
+#include "propagation.h"
+
+#include <cassert>
+#include <exception>
+#include <thread>
+#include <z3++.h>
+#include <z3_api.h>
+
+namespace pdr
+{
+  using std::vector;
+  using z3::expr;
+  using z3::expr_vector;
+
+  namespace
+  {
+    // z3 contexts may not be shared between threads. translation reads the
+    // source context, so it is done before the workers start
+    expr translate(expr const& e, z3::context& target)
+    {
+      Z3_ast rv = Z3_translate(e.ctx(), e, target);
+      target.check_error();
+      return expr(target, rv);
+    }
+  } // namespace
+
+  PropagationPool::Worker::Worker(Context const& settings)
+      : ctx(z3_ctx, settings), solver(ISolverBackend::make(ctx))
+  {
+  }
+
+  PropagationPool::PropagationPool(Context const& ctx, unsigned n_workers)
+  {
+    assert(n_workers > 0);
+    for (unsigned i{ 0 }; i < n_workers; i++)
+      workers.push_back(std::make_unique<Worker>(ctx));
+  }
+
+  void PropagationPool::sync(
+      expr_vector const& assertions, unsigned generation, vector<expr> const& act)
+  {
+    if (synced_generation != generation || assertions.size() < n_synced)
+    {
+      for (auto& w : workers)
+        w->solver->reset();
+      n_synced          = 0;
+      synced_generation = generation;
+    }
+
+    for (auto& w : workers)
+    {
+      for (unsigned i = n_synced; i < assertions.size(); i++)
+        w->solver->add(translate(assertions[i], w->z3_ctx));
+
+      // frames may have been popped, their literals are reused
+      if (w->act.size() > act.size())
+        w->act.erase(w->act.begin() + act.size(), w->act.end());
+      for (size_t i = w->act.size(); i < act.size(); i++)
+        w->act.push_back(translate(act[i], w->z3_ctx));
+    }
+    n_synced = assertions.size();
+  }
+
+  void PropagationPool::interrupt()
+  {
+    for (auto& w : workers)
+      w->z3_ctx.interrupt();
+  }
+
+  vector<bool> PropagationPool::trans_source(
+      size_t level, vector<expr_vector> const& dest_p)
+  {
+    assert(level > 0); // F_0 is not in the delta solver
+    size_t n = workers.size();
+
+    // the queries of each worker, in its own context
+    vector<vector<expr_vector>> queries(n);
+    for (size_t j{ 0 }; j < dest_p.size(); j++)
+    {
+      Worker& w = *workers[j % n];
+      expr_vector assumptions(w.z3_ctx);
+      for (expr const& l : dest_p[j])
+        assumptions.push_back(translate(l, w.z3_ctx));
+      for (size_t i = level; i < w.act.size(); i++)
+        assumptions.push_back(w.act[i]);
+      queries[j % n].push_back(assumptions);
+    }
+
+    // vector<bool> is not safe for concurrent writes
+    vector<char> results(dest_p.size(), 0);
+    vector<std::exception_ptr> errors(n);
+    vector<std::thread> threads;
+    threads.reserve(n);
+    for (size_t w{ 0 }; w < n; w++)
+    {
+      threads.emplace_back(
+          [&, w]()
+          {
+            try
+            {
+              for (size_t q{ 0 }; q < queries[w].size(); q++)
+                results[w + q * n] = workers[w]->solver->check(queries[w][q]);
+            }
+            catch (...)
+            {
+              errors[w] = std::current_exception();
+            }
+          });
+    }
+    for (std::thread& t : threads)
+      t.join();
+
+    for (std::exception_ptr const& e : errors)
+      if (e)
+        std::rethrow_exception(e);
+
+    return vector<bool>(results.begin(), results.end());
+  }
+
+  size_t PropagationPool::size() const { return workers.size(); }
+} // namespace pdr
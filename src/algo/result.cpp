@@ -38,17 +38,15 @@ namespace pdr
     };
 
     // convert a linked list of PdrStates
-    TraceVec make_trace_marking(shared_ptr<const PdrState> s)
+    TraceVec make_trace_marking(PdrState const* s, LitTable const& lits)
     {
       TraceVec rv;
-      while (s)
+      for (Cube const& c : s->trace())
       {
         vector<LitStr> state;
-        for (z3::expr const& e : s->cube)
-          state.push_back(z3ext::LitStr(e));
+        for (lit_t l : c)
+          state.push_back(z3ext::LitStr(lits(l)));
         rv.push_back(state);
-
-        s = s->prev;
       }
       return rv;
     }
@@ -75,8 +73,8 @@ namespace pdr
   // {
   // }
   Trace::Trace(unsigned l) : length{ l }, n_marked{ 0 } {}
-  Trace::Trace(shared_ptr<const PdrState> s)
-      : states(make_trace_marking(s)),
+  Trace::Trace(PdrState const& s, LitTable const& lits)
+      : states(make_trace_marking(&s, lits)),
         length(states.size()), // discludes I (not a transition step)
         n_marked(greatest_marking(states))
   {
@@ -92,7 +90,10 @@ namespace pdr
   //
   PdrResult::PdrResult(std::variant<Invariant, Trace> o) : output(o) {}
 
-  PdrResult::PdrResult(std::shared_ptr<PdrState> s) : output(Trace(s)) {}
+  PdrResult::PdrResult(PdrState const& s, LitTable const& lits)
+      : output(Trace(s, lits))
+  {
+  }
 
   PdrResult::PdrResult(int level) : output(Invariant(level)) {}
 
@@ -103,13 +104,9 @@ namespace pdr
   {
     return PdrResult(trace);
   }
-  PdrResult PdrResult::found_trace(std::shared_ptr<PdrState> s)
-  {
-    return PdrResult(s);
-  }
-  PdrResult PdrResult::found_trace(PdrState&& s)
+  PdrResult PdrResult::found_trace(PdrState const& s, LitTable const& lits)
   {
-    return PdrResult(std::make_shared<PdrState>(s));
+    return PdrResult(s, lits);
   }
   PdrResult PdrResult::incomplete_trace(unsigned length)
   {
@@ -124,7 +121,7 @@ namespace pdr
   PdrResult PdrResult::found_invariant(int level) { return PdrResult(level); }
 
   PdrResult PdrResult::empty_true() { return PdrResult(-1); }
-  PdrResult PdrResult::empty_false() { return PdrResult(nullptr); }
+  PdrResult PdrResult::empty_false() { return PdrResult(Trace()); }
 
   void PdrResult::append_final(z3::expr_vector const& f)
   {
@@ -0,0 +1,446 @@
+#include "solver-backend.h"
+#include "cdcl.h"
+#include "z3-ext.h"
+
+#include <algorithm>
+#include <fmt/core.h>
+#include <optional>
+#include <stdexcept>
+#include <z3++.h>
+#include <z3_api.h>
+
+namespace pdr
+{
+  using std::vector;
+  using z3::expr;
+  using z3::expr_vector;
+
+  std::shared_ptr<ISolverBackend> ISolverBackend::make(Context const& ctx)
+  {
+    if (ctx.cdcl)
+      return std::make_shared<CdclBackend>(ctx);
+    return std::make_shared<Z3Backend>(ctx);
+  }
+
+  // Z3Backend
+  //
+  Z3Backend::Z3Backend(Context const& ctx)
+      : solver(ctx.z3_ctx), interrupt(ctx.interrupt)
+  {
+    solver.set("sat.random_seed", ctx.seed);
+    solver.set("sat.cardinality.solver", true);
+    // consecution_solver.set("lookahead_simplify", true);
+  }
+
+  void Z3Backend::reset() { solver.reset(); }
+  void Z3Backend::push() { solver.push(); }
+  void Z3Backend::pop(unsigned n) { solver.pop(n); }
+  void Z3Backend::add(expr const& e) { solver.add(e); }
+
+  bool Z3Backend::check(expr_vector const& assumptions)
+  {
+    // a z3 interrupt only breaks off a check that is already running
+    if (interrupt && interrupt->load(std::memory_order_relaxed))
+      throw Interrupted();
+
+    z3::check_result result = solver.check(assumptions);
+    // z3 gives up when its context is interrupted
+    if (result == z3::check_result::unknown && interrupt &&
+        interrupt->load(std::memory_order_relaxed))
+      throw Interrupted();
+    assert(result != z3::check_result::unknown);
+    return result == z3::sat;
+  }
+
+  expr_vector Z3Backend::assertions() const { return solver.assertions(); }
+
+  vector<expr> Z3Backend::model_lits(
+      std::function<bool(expr const&)> const& p) const
+  {
+    z3::model m = solver.get_model();
+    vector<expr> rv;
+    rv.reserve(m.num_consts());
+
+    for (unsigned i = 0; i < m.size(); i++)
+    {
+      z3::func_decl f    = m[i];
+      expr boolean_value = m.get_const_interp(f);
+      expr literal       = f();
+
+      if (p(literal))
+      {
+        if (boolean_value.is_true())
+          rv.push_back(literal);
+        else if (boolean_value.is_false())
+          rv.push_back(!literal);
+        else
+          throw std::runtime_error(fmt::format(
+              "witness contains non-constant: {}", boolean_value.to_string()));
+      }
+    }
+
+    return rv;
+  }
+
+  vector<std::optional<bool>> Z3Backend::model_values(
+      expr_vector const& constants) const
+  {
+    z3::model m = solver.get_model();
+    vector<std::optional<bool>> rv;
+    rv.reserve(constants.size());
+
+    for (expr const& c : constants)
+    {
+      z3::func_decl f = c.decl();
+      if (!m.has_interp(f))
+      {
+        rv.emplace_back();
+        continue;
+      }
+
+      expr boolean_value = m.get_const_interp(f);
+      if (boolean_value.is_true())
+        rv.emplace_back(true);
+      else if (boolean_value.is_false())
+        rv.emplace_back(false);
+      else
+        throw std::runtime_error(fmt::format(
+            "witness contains non-constant: {}", boolean_value.to_string()));
+    }
+
+    return rv;
+  }
+
+  vector<expr> Z3Backend::unsat_core() const
+  {
+    return z3ext::convert(solver.unsat_core());
+  }
+
+  // CdclBackend
+  //
+  CdclBackend::CdclBackend(Context const& ctx)
+      : z3_ctx(ctx.z3_ctx),
+        seed(ctx.seed),
+        interrupt(ctx.interrupt),
+        encoded_exprs(z3_ctx),
+        asserted(z3_ctx),
+        last_assumptions(z3_ctx)
+  {
+    reset();
+  }
+
+  void CdclBackend::reset()
+  {
+    sat = std::make_unique<mysat::cdcl::Solver>(seed);
+    sat->set_interrupt(interrupt);
+    encoded.clear();
+    encoded_exprs.resize(0);
+    constants.clear();
+    true_lit.reset();
+    asserted.resize(0);
+    scope_marks.clear();
+  }
+
+  void CdclBackend::push()
+  {
+    sat->push();
+    scope_marks.push_back(asserted.size());
+  }
+
+  void CdclBackend::pop(unsigned n)
+  {
+    assert(n <= scope_marks.size());
+    if (n == 0)
+      return;
+
+    sat->pop(n);
+    asserted.resize(scope_marks[scope_marks.size() - n]);
+    scope_marks.resize(scope_marks.size() - n);
+  }
+
+  void CdclBackend::add(expr const& e)
+  {
+    asserted.push_back(e);
+    assert_top(e);
+  }
+
+  // top-level conjunctions and clauses need no tseitin variable
+  void CdclBackend::assert_top(expr const& e)
+  {
+    if (e.is_true())
+      return;
+
+    if (e.is_and())
+    {
+      for (unsigned i = 0; i < e.num_args(); i++)
+        assert_top(e.arg(i));
+      return;
+    }
+
+    vector<lit_t> clause;
+    if (e.is_or())
+    {
+      clause.reserve(e.num_args());
+      for (unsigned i = 0; i < e.num_args(); i++)
+        clause.push_back(lit(e.arg(i)));
+    }
+    else
+      clause.push_back(lit(e));
+
+    sat->add_clause(clause);
+  }
+
+  bool CdclBackend::check(expr_vector const& assumptions)
+  {
+    // the solver itself only looks at the flag between restarts
+    if (interrupt && interrupt->load(std::memory_order_relaxed))
+      throw Interrupted();
+
+    last_assumptions = assumptions;
+    last_assumption_lits.clear();
+    last_assumption_lits.reserve(assumptions.size());
+    for (expr const& a : assumptions)
+      last_assumption_lits.push_back(lit(a));
+
+    bool result = sat->solve(last_assumption_lits);
+    if (sat->interrupted())
+      throw Interrupted();
+    return result;
+  }
+
+  expr_vector CdclBackend::assertions() const { return asserted; }
+
+  vector<expr> CdclBackend::model_lits(
+      std::function<bool(expr const&)> const& p) const
+  {
+    using mysat::cdcl::lbool;
+
+    vector<expr> rv;
+    for (auto const& [v, e] : constants)
+    {
+      if (p(e))
+      {
+        lbool value = sat->model_value(v);
+        assert(value != lbool::Undef);
+        rv.push_back(value == lbool::True ? e : !e);
+      }
+    }
+
+    return rv;
+  }
+
+  vector<std::optional<bool>> CdclBackend::model_values(
+      expr_vector const& constants) const
+  {
+    using mysat::cdcl::lbool;
+
+    vector<std::optional<bool>> rv;
+    rv.reserve(constants.size());
+    for (expr const& c : constants)
+    {
+      // constants that were never encoded do not occur in the solver
+      auto found = encoded.find(c.id());
+      if (found == encoded.end())
+      {
+        rv.emplace_back();
+        continue;
+      }
+
+      lbool value = sat->model_value(mysat::cdcl::var(found->second));
+      assert(value != lbool::Undef);
+      rv.emplace_back(
+          (value == lbool::True) != mysat::cdcl::sign(found->second));
+    }
+
+    return rv;
+  }
+
+  vector<expr> CdclBackend::unsat_core() const
+  {
+    vector<lit_t> failed = sat->failed();
+    std::sort(failed.begin(), failed.end());
+
+    vector<expr> rv;
+    for (unsigned i = 0; i < last_assumption_lits.size(); i++)
+      if (std::binary_search(
+              failed.begin(), failed.end(), last_assumption_lits[i]))
+        rv.push_back(last_assumptions[i]);
+
+    return rv;
+  }
+
+  // ENCODING
+  //
+  CdclBackend::lit_t CdclBackend::lit(expr const& e)
+  {
+    using mysat::cdcl::mk_lit;
+    using mysat::cdcl::negate;
+
+    if (e.is_not())
+      return negate(lit(e.arg(0)));
+
+    auto found = encoded.find(e.id());
+    if (found != encoded.end())
+      return found->second;
+
+    lit_t rv;
+    if (e.is_const() && !e.is_true() && !e.is_false())
+    {
+      var_t v = sat->new_var();
+      constants.emplace_back(v, e);
+      rv = mk_lit(v);
+    }
+    else
+      rv = encode(e);
+
+    encoded.emplace(e.id(), rv);
+    encoded_exprs.push_back(e);
+    return rv;
+  }
+
+  CdclBackend::lit_t CdclBackend::encode(expr const& e)
+  {
+    using mysat::cdcl::negate;
+
+    if (!e.is_bool())
+      throw std::invalid_argument(fmt::format(
+          "cdcl backend expects boolean formulas: {}", e.to_string()));
+
+    vector<lit_t> args;
+    for (unsigned i = 0; i < e.num_args(); i++)
+      args.push_back(lit(e.arg(i)));
+
+    switch (e.decl().decl_kind())
+    {
+      case Z3_OP_TRUE: return mk_true();
+      case Z3_OP_FALSE: return negate(mk_true());
+      case Z3_OP_AND: return mk_and(args);
+      case Z3_OP_OR: return mk_or(args);
+      case Z3_OP_IMPLIES: return mk_or({ negate(args.at(0)), args.at(1) });
+      case Z3_OP_EQ:
+      case Z3_OP_IFF: return negate(mk_xor(args.at(0), args.at(1)));
+      case Z3_OP_DISTINCT:
+        if (args.size() == 2)
+          return mk_xor(args[0], args[1]);
+        break;
+      case Z3_OP_XOR:
+      {
+        lit_t rv = negate(mk_true());
+        for (lit_t a : args)
+          rv = mk_xor(rv, a);
+        return rv;
+      }
+      case Z3_OP_ITE: return mk_ite(args.at(0), args.at(1), args.at(2));
+      case Z3_OP_PB_AT_MOST:
+      {
+        int k = Z3_get_decl_int_parameter(e.ctx(), e.decl(), 0);
+        return negate(mk_more_than(args, k));
+      }
+      case Z3_OP_PB_AT_LEAST:
+      {
+        int k = Z3_get_decl_int_parameter(e.ctx(), e.decl(), 0);
+        if (k <= 0)
+          return mk_true();
+        return mk_more_than(args, k - 1);
+      }
+      default: break;
+    }
+
+    throw std::invalid_argument(fmt::format(
+        "cdcl backend cannot encode: {}", e.decl().name().str()));
+  }
+
+  CdclBackend::lit_t CdclBackend::mk_true()
+  {
+    if (!true_lit)
+    {
+      true_lit = mysat::cdcl::mk_lit(sat->new_var());
+      sat->add_permanent({ *true_lit });
+    }
+    return *true_lit;
+  }
+
+  // g <-> a1 & ... & an
+  CdclBackend::lit_t CdclBackend::mk_and(vector<lit_t> const& args)
+  {
+    using mysat::cdcl::negate;
+
+    lit_t g = mysat::cdcl::mk_lit(sat->new_var());
+    vector<lit_t> long_clause{ g };
+    for (lit_t a : args)
+    {
+      sat->add_permanent({ negate(g), a });
+      long_clause.push_back(negate(a));
+    }
+    sat->add_permanent(long_clause);
+
+    return g;
+  }
+
+  // g <-> a1 | ... | an
+  CdclBackend::lit_t CdclBackend::mk_or(vector<lit_t> const& args)
+  {
+    using mysat::cdcl::negate;
+
+    vector<lit_t> negated;
+    for (lit_t a : args)
+      negated.push_back(negate(a));
+
+    return negate(mk_and(negated));
+  }
+
+  // g <-> a ^ b
+  CdclBackend::lit_t CdclBackend::mk_xor(lit_t a, lit_t b)
+  {
+    using mysat::cdcl::negate;
+
+    lit_t g = mysat::cdcl::mk_lit(sat->new_var());
+    sat->add_permanent({ negate(g), a, b });
+    sat->add_permanent({ negate(g), negate(a), negate(b) });
+    sat->add_permanent({ g, negate(a), b });
+    sat->add_permanent({ g, a, negate(b) });
+
+    return g;
+  }
+
+  // g <-> (c ? t : e)
+  CdclBackend::lit_t CdclBackend::mk_ite(lit_t c, lit_t t, lit_t e)
+  {
+    using mysat::cdcl::negate;
+
+    lit_t g = mysat::cdcl::mk_lit(sat->new_var());
+    sat->add_permanent({ negate(g), negate(c), t });
+    sat->add_permanent({ negate(g), c, e });
+    sat->add_permanent({ g, negate(c), negate(t) });
+    sat->add_permanent({ g, c, negate(e) });
+
+    return g;
+  }
+
+  // sequential counter: s[j] <-> at least j of the args seen so far
+  CdclBackend::lit_t CdclBackend::mk_more_than(
+      vector<lit_t> const& args, unsigned k)
+  {
+    using mysat::cdcl::negate;
+
+    if (args.size() <= k)
+      return negate(mk_true());
+
+    // s[0] is always true, empty entries are false
+    vector<std::optional<lit_t>> s(k + 2);
+    s[0] = mk_true();
+    for (lit_t x : args)
+    {
+      for (size_t j = k + 1; j > 0; j--)
+      {
+        if (!s[j - 1])
+          continue;
+
+        lit_t carry = j == 1 ? x : mk_and({ x, *s[j - 1] });
+        s[j]        = s[j] ? mk_or({ *s[j], carry }) : carry;
+      }
+    }
+
+    return s[k + 1].value_or(negate(mk_true()));
+  }
+} // namespace pdr
@@ -13,54 +13,88 @@ namespace pdr
   using z3::expr;
   using z3::expr_vector;
 
+  namespace
+  {
+    bool same_clauses(expr_vector const& a, expr_vector const& b)
+    {
+      if (a.size() != b.size())
+        return false;
+      for (unsigned i = 0; i < a.size(); i++)
+        if (a[i].id() != b[i].id())
+          return false;
+      return true;
+    }
+  } // namespace
+
   Solver::Solver(Context& c,
       const IModel& m,
       expr_vector base,
       expr_vector transition,
       expr_vector constraint)
-      : ctx(c), vars(m.vars), internal_solver(c)
+      : ctx(c),
+        vars(m.vars),
+        internal_solver(ISolverBackend::make(c)),
+        current_constraint(c.z3_ctx)
   {
-    internal_solver.set("sat.random_seed", ctx.seed);
-    internal_solver.set("sat.cardinality.solver", true);
-    // consecution_solver.set("lookahead_simplify", true);
     remake(base, transition, constraint);
   }
 
   unsigned Solver::n_assertions() const
   {
-    return internal_solver.assertions().size() - clauses_start;
+    return internal_solver->assertions().size() - clauses_start - n_pending;
   }
 
   double Solver::frac_subsumed() const
   {
     assert(n_clauses == n_assertions());
+    if (n_clauses == 0)
+      return 0.0;
     return (double)n_subsumed / n_clauses;
   }
 
+  expr_vector Solver::assertions() const
+  {
+    return internal_solver->assertions();
+  }
+
   void Solver::remake(
       expr_vector base, expr_vector transition, expr_vector constraint)
   {
-    internal_solver.reset();
+    internal_solver->reset();
     // backtracking point to solver without constraints or blocked states
-    internal_solver.add(base);
-    internal_solver.add(transition);
-    internal_solver.push();
+    internal_solver->add(base);
+    internal_solver->add(transition);
+    internal_solver->push();
     // backtracking point to solver without blocked states
-    internal_solver.add(constraint);
-    internal_solver.push();
+    internal_solver->add(constraint);
+    internal_solver->push();
 
     transition_start = base.size();
     clauses_start    = base.size() + transition.size() + constraint.size();
     n_subsumed       = 0;
     n_clauses        = 0;
+    pending_constraint.reset();
+    n_pending          = 0;
+    current_constraint = z3ext::copy(constraint);
+    generation++;
   }
 
   void Solver::reset()
   {
-    internal_solver.pop();  // remove all blocked states
-    internal_solver.push(); // remake backtracking point
+    if (pending_constraint)
+    {
+      // the pending constraint is in the scope of the blocked cubes, so it
+      // is asserted again below them
+      expr_vector constraint = *pending_constraint;
+      reconstrain_clear(constraint);
+      return;
+    }
+
+    internal_solver->pop();  // remove all blocked states
+    internal_solver->push(); // remake backtracking point
     n_subsumed = 0;
     n_clauses  = 0;
+    generation++;
   }
 
   // reset and automatically repopulate by blocking cubes
@@ -74,19 +108,41 @@ namespace pdr
 
   void Solver::reconstrain_clear(expr_vector constraint)
   {
-    internal_solver.pop(2); // remove all blocked cubes and constraint
-    internal_solver.push(); // remake constraintless backtracking point
-    internal_solver.add(constraint);
-    internal_solver.push(); // remake stateless backtracking point
-    clauses_start = internal_solver.assertions().size();
+    if (!pending_constraint && same_clauses(constraint, current_constraint))
+    {
+      reset(); // keep the constraint, only remove the blocked cubes
+      return;
+    }
+
+    internal_solver->pop(2); // remove all blocked cubes and constraint
+    internal_solver->push(); // remake constraintless backtracking point
+    internal_solver->add(constraint);
+    internal_solver->push(); // remake stateless backtracking point
+    clauses_start = internal_solver->assertions().size();
     n_subsumed    = 0;
     n_clauses     = 0;
+    pending_constraint.reset();
+    n_pending          = 0;
+    current_constraint = z3ext::copy(constraint);
+    generation++;
+  }
+
+  void Solver::reconstrain_tighten(expr_vector constraint)
+  {
+    if (same_clauses(constraint, current_constraint))
+      return;
+
+    // the conjunction with the old constraint is equal to the new one
+    internal_solver->add(constraint);
+    n_pending += constraint.size();
+    pending_constraint = constraint;
+    current_constraint = z3ext::copy(constraint);
   }
 
   void Solver::add_clause(expr const& e)
   {
     n_clauses++;
-    internal_solver.add(e);
+    internal_solver->add(e);
   }
 
   void Solver::block(const expr_vector& cube)
@@ -121,61 +177,51 @@ namespace pdr
 
   bool Solver::SAT(const expr_vector& assumptions)
   {
-    state                   = SolverState::fresh;
-    z3::check_result result = internal_solver.check(assumptions);
-    if (result == z3::sat)
+    state = SolverState::fresh;
+    if (internal_solver->check(assumptions))
     {
       state = SolverState::witness_available;
       return true;
     }
 
-    assert(result != z3::check_result::unknown);
-
     state = SolverState::core_available;
     return false;
   }
 
-  z3::model Solver::get_model() const { return internal_solver.get_model(); }
-
   // TODO optional return
   vector<expr> Solver::raw_unsat_core() const
   {
     if (state != SolverState::core_available)
       throw InvalidExtraction(state);
 
-    return z3ext::convert(internal_solver.unsat_core());
+    return internal_solver->unsat_core();
   }
 
-  vector<expr> Solver::std_witness_current() const
+  vector<expr> Solver::witness(mysat::primed::lit_type t) const
   {
     if (state != SolverState::witness_available)
       throw InvalidExtraction(state);
 
-    z3::model m = internal_solver.get_model();
-    vector<expr> std_vec;
-    std_vec.reserve(m.num_consts());
-
-    for (unsigned i = 0; i < m.size(); i++)
-    {
-      z3::func_decl f    = m[i];
-      expr boolean_value = m.get_const_interp(f);
-      expr literal       = f();
-      bool is_reserved =
-          ctx.simple_relax || z3ext::constrained_cube::is_reserved_lit(literal);
-
-      if (is_reserved && vars.lit_is_current(literal))
-      {
-        if (boolean_value.is_true())
-          std_vec.push_back(literal);
-        else if (boolean_value.is_false())
-          std_vec.push_back(!literal);
-        else
-          throw InvalidExtraction::NonConstant(boolean_value);
-      }
-    }
+    return vars.ordered_cube(internal_solver->model_values(vars.get(t)), t);
+  }
 
-    z3ext::order_lits(std_vec);
-    return std_vec;
+  vector<expr> Solver::std_witness_current() const
+  {
+    vector<expr> rv = witness(mysat::primed::lit_type::base);
+    if (ctx.simple_relax)
+      return rv;
+
+    // a constrained relax step asserts constraint literals (see
+    // Frames::copy_to_Fk_keep), which are part of the state
+    vector<expr> clits = internal_solver->model_lits(
+        [](expr const& e)
+        { return z3ext::constrained_cube::is_reserved_lit(e); });
+    if (clits.empty())
+      return rv;
+
+    rv.insert(rv.end(), clits.begin(), clits.end());
+    z3ext::order_lits(rv);
+    return rv;
   }
 
   expr_vector Solver::witness_current() const
@@ -193,42 +239,15 @@ namespace pdr
 
     assert(z3ext::lits_ordered(ev));
 
-    z3::model m = internal_solver.get_model();
-
-    vector<expr> std_vec;
-    std_vec.reserve(m.num_consts());
-
-    for (unsigned i = 0; i < m.size(); i++)
-    {
-      if (std_vec.size() >= ev.size()) // intersection cannot be larger than ev
-        break;
-
-      z3::func_decl f    = m[i];
-      expr boolean_value = m.get_const_interp(f);
-      expr var           = f();
-      bool is_reserved =
-          ctx.simple_relax || z3ext::constrained_cube::is_reserved_lit(var);
-
-      if (is_reserved && vars.lit_is_current(var))
-      {
-        expr literal(var.ctx());
-        if (boolean_value.is_true())
-          literal = var;
-        else if (boolean_value.is_false())
-          literal = !var;
-        else
-          throw InvalidExtraction::NonConstant(boolean_value);
-
-        // search for
-        if (std::binary_search(
-                ev.begin(), ev.end(), literal, z3ext::cube_orderer))
-        {
-          std_vec.push_back(literal);
-        }
-      }
-    }
+    vector<expr> std_vec = std_witness_current();
+    auto last            = std::remove_if(std_vec.begin(), std_vec.end(),
+                   [&ev](expr const& literal)
+                   {
+                     return !std::binary_search(
+                         ev.begin(), ev.end(), literal, z3ext::cube_orderer);
+                   });
+    std_vec.erase(last, std_vec.end());
 
-    z3ext::order_lits(std_vec);
     return std_vec;
   }
 
@@ -237,9 +256,9 @@ namespace pdr
     std::stringstream ss;
     ss << header << std::endl;
     // ss << "z3::statistics" << std::endl;
-    // ss << internal_solver.statistics() << std::endl;
+    // ss << internal_solver->statistics() << std::endl;
 
-    const expr_vector asserts = internal_solver.assertions();
+    const expr_vector asserts = internal_solver->assertions();
     auto it                   = asserts.begin();
     unsigned i                = 0;
 
@@ -1,5 +1,6 @@
 #include "z3-ext.h"
 #include "expr.h"
+#include "tseytin.h"
 #include "types-ext.h"
 
 #include <algorithm>
@@ -817,22 +818,9 @@ namespace z3ext
   {
     expr_vector to_cnf_vec(expr e)
     {
-      e = e.simplify();
-      z3::tactic simplify(e.ctx(), "simplify");
-      // z3::tactic simplify(e.ctx(), "ctx-simplify");
-      z3::tactic cnf(e.ctx(), "tseitin-cnf");
-
-      z3::tactic t = cnf & simplify;
-      z3::goal g(e.ctx());
-
-      g.add(e);
-      z3::apply_result r = t(g);
-      assert(r.size() == 1);
-      expr_vector clauses(e.ctx());
-      for (size_t i = 0; i < r[0].size(); i++)
-        clauses.push_back(r[0][i]);
-
-      return clauses;
+      Encoder cnf(e.ctx());
+      cnf.add(e);
+      return cnf.clauses();
     }
 
     expr to_cnf(expr const& e) { return mk_and(to_cnf_vec(e)); }
@@ -884,5 +872,45 @@ namespace z3ext
       cnf.push_back(!c || !a || b);
       return c;
     }
+
+    namespace
+    {
+      vector<expr> totalize(expr_vector& cnf, string const& name,
+          expr_vector const& lits, size_t begin, size_t end, size_t cap)
+      {
+        if (end - begin == 1)
+          return { lits[begin] };
+
+        size_t mid      = begin + (end - begin) / 2;
+        vector<expr> lo = totalize(cnf, name, lits, begin, mid, cap);
+        vector<expr> hi = totalize(cnf, name, lits, mid, end, cap);
+
+        vector<expr> out;
+        size_t n = std::min(lo.size() + hi.size(), cap);
+        for (size_t j = 0; j < n; j++)
+        {
+          string out_name = fmt::format("{}[{},{})[{}]_", name, begin, end, j);
+          out.push_back(cnf.ctx().bool_const(out_name.c_str()));
+        }
+
+        for (size_t i = 0; i < lo.size() && i < n; i++)
+          cnf.push_back(!lo[i] || out[i]);
+        for (size_t j = 0; j < hi.size() && j < n; j++)
+          cnf.push_back(!hi[j] || out[j]);
+        for (size_t i = 0; i < lo.size(); i++)
+          for (size_t j = 0; j < hi.size() && i + j + 1 < n; j++)
+            cnf.push_back(!lo[i] || !hi[j] || out[i + j + 1]);
+
+        return out;
+      }
+    } // namespace
+
+    vector<expr> add_totalizer(
+        expr_vector& cnf, string const& name, expr_vector const& lits, size_t cap)
+    {
+      if (lits.empty() || cap == 0)
+        return {};
+      return totalize(cnf, name, lits, 0, lits.size(), cap);
+    }
   } // namespace tseytin
 } // namespace z3ext
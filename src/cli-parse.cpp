@@ -2,6 +2,7 @@
 #include "h-operator.h"
 #include "io.h"
 #include "logger.h"
+#include "parse_bench.h"
 #include "parse_tfc.h"
 #include "tactic.h"
 #include "types-ext.h"
@@ -37,7 +38,11 @@ namespace my::cli
     // NAME
     struct src_name_visitor
     {
-      string operator()(benchFile const& a) const { return a.name; }
+      // the graphs of both readers differ, so do their names
+      string operator()(benchFile const& a) const
+      {
+        return a.gates ? a.name + "_gates" : a.name;
+      }
 
       string operator()(tfcFile const& a) const { return a.name; }
 
@@ -57,6 +62,8 @@ namespace my::cli
     {
       dag::Graph operator()(benchFile const& a) const
       {
+        if (a.gates)
+          return parse::read_bench(a.file.string(), get_name(a));
 
         mockturtle::klut_network klut;
         auto const result =
@@ -65,13 +72,12 @@ namespace my::cli
           throw std::invalid_argument(
               a.file.string() + " is not a valid .bench file");
 
-        return dag::from_dot(klut, a.name);
+        return dag::from_network(klut, a.name);
       }
 
       dag::Graph operator()(tfcFile const& a) const
       {
-        parse::TFCParser parser;
-        return parser.parse_file(a.file.string(), a.name);
+        return parse::read_tfc(a.file.string(), a.name);
       }
 
       dag::Graph operator()(Hop const& a) const
@@ -103,6 +109,9 @@ namespace my::cli
 
       string operator()(Peterson const& m) const
       {
+        if (m.symmetry_check)
+          return format("peterson symmetry check. 3 and 4 processes, {} steps.",
+              *m.symmetry_check);
         if (m.switch_bound)
           return format("peterson algorithm. {} processes. context switches "
                         "bounded by {}.",
@@ -110,6 +119,11 @@ namespace my::cli
         else
           return format("peterson algorithm. {} processes.", m.processes);
       }
+
+      string operator()(Aiger const& m) const
+      {
+        return format("aiger safety check of {}.", m.name);
+      }
     };
     string describe(Model_var const& m)
     {
@@ -128,6 +142,8 @@ namespace my::cli
       {
         return format("{}procs", m.processes);
       }
+
+      string operator()(Aiger const& m) const { return m.name; }
     };
     string src_name(Model_var const& m)
     {
@@ -148,6 +164,12 @@ namespace my::cli
         (void)m;
         return "peter";
       }
+
+      string operator()(Aiger const& m) const
+      {
+        (void)m;
+        return "aiger";
+      }
     };
     string get_name(Model_var const& m)
     {
@@ -159,10 +181,9 @@ namespace my::cli
     {
       string operator()(Pebbling const& m) const
       {
-        if (m.max_pebbles)
-          return format("pebbling_{}", *m.max_pebbles);
-        else
-          return "pebbling";
+        string tag =
+            m.max_pebbles ? format("pebbling_{}", *m.max_pebbles) : "pebbling";
+        return m.reduce ? tag + "_reduced" : tag;
       }
 
       string operator()(Peterson const& m) const
@@ -172,12 +193,25 @@ namespace my::cli
         else
           return format("peter", m.processes);
       }
+
+      string operator()(Aiger const& m) const
+      {
+        (void)m;
+        return "aiger";
+      }
     };
 
     string filetag(Model_var const& m)
     {
       return std::visit(model_t_tag_visitor{}, m);
     }
+
+    dag::Graph make_graph(Pebbling const& m)
+    {
+      if (m.reduce)
+        return graph_src::make_graph(m.src).reduced();
+      return graph_src::make_graph(m.src);
+    }
   } // namespace model_t
 
   //////////////
@@ -329,6 +363,12 @@ namespace my::cli
 
     if (tseytin)
       out << "Using tseytin encoded transition." << endl;
+    if (cdcl)
+      out << "Using embedded cdcl solver." << endl;
+    if (portfolio)
+      out << format("Racing a portfolio of {} pdr instances{}.", *portfolio,
+                 share_lemmas ? " that share lemmas" : "")
+          << endl;
     out << endl;
   }
 
@@ -355,8 +395,9 @@ namespace my::cli
     clopt.positional_help(format("{} {} {}", o_problem, o_alg, o_mode));
     clopt.add_options("positional parameter")
       (o_problem, 
-       format("Solve the Reversible Pebbling Problem "
-         "or verify correctness of the Peterson Protocol:\n{}", problem_group),
+       format("Solve the Reversible Pebbling Problem, "
+         "verify correctness of the Peterson Protocol "
+         "or check an aiger safety property:\n{}", problem_group),
        value<string>())
       (o_alg, 
        format("Choose an algorithm to use:\n{}.", algo_group),
@@ -379,6 +420,7 @@ namespace my::cli
         value<fs::path>(folders.bench_src)->default_value(my::io::BENCH_FOLDER), "(string:F)")
       (s_bench, "File in in .bench format.",
         value<string>(), "(string:FILE)")
+      (s_bench_gates, "Read the .bench file with the built-in memory-mapped reader, which makes a node of every gate as written. Faster on large netlists than the default xmg decomposition, but gives a different graph.")
       (s_tfc, "File in in .tfc format.",
         value<string>(), "(string:FILE)")
       (s_hop, "Construct h-operator model from provided bitwidth (BITS) and modulus (MOD).",
@@ -390,20 +432,40 @@ namespace my::cli
         value<unsigned>(), "(uint:SEED)")
       (s_tseytin, "Build the transition relation using z3's tseytin reform.",
         value<bool>(tseytin)->default_value("false"))
+      (s_cdcl, "Use the embedded cdcl sat solver instead of z3 for pdr's queries.",
+        value<bool>(cdcl)->default_value("false"))
+      (s_portfolio, "Race N pdr instances with different seeds and generalization settings on separate threads. The first result is kept. (pdr run only)",
+        value<unsigned>(), "(uint:N)")
+      (s_share, "Let portfolio instances exchange the cubes they block. Imported cubes are checked for relative inductiveness first. (Default = true)",
+        value<bool>(share_lemmas)->default_value("true"))
       (s_show, "Only write the given model to its output file, does not run the algorithm.",
         value<bool>(onlyshow)->default_value("false"))
 
       (s_copy_constrain, "Copy cubes with previous constraint attached.")
       (s_skip_blocked, "Skip cubes for which a stronger cube is already blocked. (Default = true)",
        value<bool>(), "(Bool)")
+      (s_lift, "Reduce predecessors to the literals that still force the transition, if the model supports it. (Default = true)",
+       value<bool>(), "(Bool)")
+      (s_symmetry, "Also block the images of blocked cubes under the symmetries of the model, if it has any. (Default = true)",
+       value<bool>(), "(Bool)")
       (s_mic, "Limit on the number of times N that pdr retries dropping a literal in MIC. (Default = UINT_MAX)",
        value<unsigned>(), "(uint:N)")
+      (s_mic_mode, "Generalization in MIC: drop literals plainly, block counters-to-generalization on the way (ctg), or switch to ctg on levels where plain MIC fails often (ctg-adaptive). (Default = plain)",
+       value<string>(), "(plain|ctg|ctg-adaptive)")
       (s_subsumed, "Once this fraction of clauses in the sat-solver are subsumed by subclauses, refresh the solver and discard them. (Default = 0.5)",
-       value<unsigned>(), "(uint:N)")
+       value<double>(), "(double:N)")
       (s_ctgdepth, "Limit on the depth of CTGdown recursion. (Default = 1)",
        value<unsigned>(), "(uint:N)")
       (s_ctgnum, "Limit on the number of ctgs (counters-to-generalization) handled by CTGdown. (Default = 3)",
-       value<unsigned>(), "(uint:N)");
+       value<unsigned>(), "(uint:N)")
+      (s_prop_threads, "Check the cubes of the propagation phase on N threads, each with a copy of the solver. (Default = 1)",
+       value<unsigned>(), "(uint:N)")
+      (s_lemma_cache, "Store the cubes blocked by pdr in DIR, per model and constraint, and start from the stored cubes that still hold.",
+       value<string>(), "(string:DIR)")
+      (s_checkpoint, "Write the progress of an ipdr relax run to FILE after every proven bound. (pebbling only)",
+       value<string>(), "(string:FILE)")
+      (s_resume, "Continue an ipdr relax run from the file given by `checkpoint`, if it exists.",
+       value<bool>(resume)->default_value("false"));
 
     clopt.add_options("output-level")
       (sh('v', s_verbose), "Output all messages during pdr iterations")
@@ -415,7 +477,8 @@ namespace my::cli
     //  problems
     clopt.add_options(s_pebbling)
       (s_pebbles, "Number of pebbles for a single pebbling pdr run.",
-       value<unsigned>(), "(uint)");
+       value<unsigned>(), "(uint)")
+      (s_reduce, "Drop the nodes that no output depends on before building the model. Does not change the optimum.");
 
     clopt.add_options(s_peter)
       // (s_mprocs, "REQUIRED. The maximum number of processes for the Peterson Protocol transition system.",
@@ -423,7 +486,13 @@ namespace my::cli
       (s_mswitch, "The maximum number of context switches allowed for the Peterson Protocol transition system. For IPDR: the highest bound to check, starting at 0.",
        value<unsigned>(), "(uint)")
       (s_procs, "REQUIRED. Number of processes for a single peterson pdr run, or the starting value for ipdr.",
-       value<unsigned>(), "(uint)");
+       value<unsigned>(), "(uint)")
+      (s_check_symmetry, "Instead of a run, explore the 3 and 4 process models for STEPS steps and check that the images of each state under process permutations are reached at the same step. Exits with 1 if one is not.",
+       value<unsigned>(), "(uint:STEPS)");
+
+    clopt.add_options(s_aiger)
+      (s_aig, "REQUIRED. File in .aig (binary) or .aag (ascii) aiger format.",
+       value<string>(), "(string:FILE)");
 
     // algorithms
     clopt.add_options(s_ipdr)
@@ -493,6 +562,18 @@ namespace my::cli
                     << std::endl;
       }
     }
+
+    // if filename has an extension, it must be ext.
+    // return filename without any extension
+    std::string strip_extension(fs::path const& filename, std::string_view ext)
+    {
+      std::string extension = filename.extension();
+      if (extension == format(".{}", ext) || extension == "")
+        return filename.stem();
+
+      throw std::invalid_argument(
+          format("benchmark file must have extension .{}", ext));
+    }
   } // namespace
 
   void ArgumentList::parse_problem(cxxopts::ParseResult const& clresult)
@@ -503,17 +584,40 @@ namespace my::cli
 
     if (problem == s_peter)
     {
-      ignored({ s_pebbles }, clresult);
+      ignored({ s_pebbles, s_reduce, s_bench_gates }, clresult);
+      model_t::Peterson peter;
+
+      if (clresult.count(s_check_symmetry))
+      {
+        // the check builds its own models
+        ignored({ s_mswitch, s_procs, s_check_symmetry }, clresult);
+        peter.processes      = 0;
+        peter.symmetry_check = clresult[s_check_symmetry].as<unsigned>();
+        model                = peter;
+        return;
+      }
+
       require_one_of({ s_mswitch }, clresult);
       require_one_of({ s_procs }, clresult);
 
-      model_t::Peterson peter;
-
       peter.switch_bound = clresult[s_mswitch].as<unsigned>();
       peter.processes    = clresult[s_procs].as<unsigned>();
 
       model = peter;
     }
+    else if (problem == s_aiger)
+    {
+      ignored({ s_pebbles, s_reduce, s_bench_gates, s_mswitch, s_procs,
+                  s_check_symmetry },
+          clresult);
+      require_one_of({ s_aig }, clresult);
+
+      fs::path file(clresult[s_aig].as<string>());
+      string ext = file.extension() == ".aag" ? "aag" : "aig";
+      string name = strip_extension(file, ext);
+
+      model = model_t::Aiger{ name, folders.src_file(name, ext) };
+    }
     else
     {
       assert(problem == s_pebbling);
@@ -526,6 +630,8 @@ namespace my::cli
       if (clresult.count(s_pebbles))
         pebbling.max_pebbles = clresult[s_pebbles].as<unsigned>();
 
+      pebbling.reduce = clresult.count(s_reduce) > 0;
+
       model = pebbling;
     }
   }
@@ -545,6 +651,10 @@ namespace my::cli
     {
       pdr::Tactic t;
 
+      if (is<model_t::Aiger>(model))
+        throw std::invalid_argument(
+            "IPDR requires a constraint to vary, aiger models have none.");
+
       // default
       if (is<model_t::Pebbling>(model))
         t = pdr::Tactic::constrain;
@@ -619,6 +729,10 @@ namespace my::cli
         throw std::invalid_argument(
             "Experiments verify incremental (non-pdr) runs only");
 
+      if (is<model_t::Aiger>(model))
+        throw std::invalid_argument(
+            "Experiments are not supported for aiger models");
+
       experiment = { reps, seeds };
     }
   }
@@ -645,11 +759,20 @@ namespace my::cli
     if (clresult.count(s_skip_blocked))
       skip_blocked = clresult[s_skip_blocked].as<bool>();
 
+    if (clresult.count(s_lift))
+      lift = clresult[s_lift].as<bool>();
+
+    if (clresult.count(s_symmetry))
+      symmetry = clresult[s_symmetry].as<bool>();
+
     if (clresult.count(s_mic))
       mic_retries = clresult[s_mic].as<unsigned>();
 
+    if (clresult.count(s_mic_mode))
+      mic_mode = pdr::mic::mk_mode(clresult[s_mic_mode].as<string>());
+
     if (clresult.count(s_subsumed))
-      subsumed_cutoff = clresult[s_subsumed].as<unsigned>();
+      subsumed_cutoff = clresult[s_subsumed].as<double>();
 
     if (clresult.count(s_ctgdepth))
       ctg_max_depth = clresult[s_ctgdepth].as<unsigned>();
@@ -657,23 +780,48 @@ namespace my::cli
     if (clresult.count(s_ctgnum))
       ctg_max_counters = clresult[s_ctgnum].as<unsigned>();
 
-    // s_tseytin and s_show are set automatically
-  }
+    if (clresult.count(s_prop_threads))
+    {
+      propagation_threads = clresult[s_prop_threads].as<unsigned>();
+      if (*propagation_threads == 0)
+        throw std::invalid_argument(
+            format("`{}` requires at least one thread", s_prop_threads));
+    }
 
-  namespace
-  {
-    // if filename has an extension, it must be ext.
-    // return filename without any extension
-    std::string strip_extension(fs::path const& filename, std::string_view ext)
+    if (clresult.count(s_lemma_cache))
+      lemma_cache = fs::path(clresult[s_lemma_cache].as<string>());
+
+    if (clresult.count(s_checkpoint))
     {
-      std::string extension = filename.extension();
-      if (extension == format(".{}", ext) || extension == "")
-        return filename.stem();
+      auto ipdr = variant::get_cref<algo::t_IPDR>(algorithm);
+      if (!ipdr || ipdr->get().type != pdr::Tactic::relax ||
+          !is<model_t::Pebbling>(model) || experiment || z3pdr)
+        throw std::invalid_argument(
+            format("`{}` is only supported for a single ipdr relax run over "
+                   "pebbling",
+                s_checkpoint));
+
+      checkpoint = fs::path(clresult[s_checkpoint].as<string>());
+    }
 
+    if (resume && !checkpoint)
       throw std::invalid_argument(
-          format("benchmark file must have extension .{}", ext));
+          format("`{}` requires `{}`", s_resume, s_checkpoint));
+
+    if (clresult.count(s_portfolio))
+    {
+      if (!is<algo::t_PDR>(algorithm) || experiment || z3pdr)
+        throw std::invalid_argument(
+            format("`{}` is only supported for a single pdr run", s_portfolio));
+
+      portfolio = clresult[s_portfolio].as<unsigned>();
+      if (*portfolio == 0)
+        throw std::invalid_argument(
+            format("`{}` requires at least one instance", s_portfolio));
     }
-  } // namespace
+
+    // s_tseytin, s_cdcl, s_share and s_show are set automatically
+  }
 
   graph_src::Graph_var ArgumentList::parse_graph_src(
       cxxopts::ParseResult const& clresult)
@@ -705,7 +853,8 @@ namespace my::cli
 
       string name = clresult[s_bench].as<string>();
       name        = strip_extension(name, "bench");
-      rv = graph_src::benchFile{ name, folders.src_file(name, "bench") };
+      rv = graph_src::benchFile{ name, folders.src_file(name, "bench"),
+        clresult.count(s_bench_gates) > 0 };
     }
 
     return rv;
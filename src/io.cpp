@@ -5,11 +5,21 @@
 // #include <filesystem>
 #include <fmt/core.h>
 #include <ghc/filesystem.hpp>
+#include <iterator>
+#include <random>
+#include <stdexcept>
 #include <string>
 #include <string_view>
 #include <tabulate/table.hpp>
 #include <type_traits>
 
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 namespace my::io
 {
   using namespace pdr::tactic;
@@ -46,6 +56,72 @@ namespace my::io
     return trunc_file(folder / format("{}.{}", filename, ext));
   }
 
+  void replace_file(
+      fs::path const& path, std::function<void(std::ostream&)> const& write)
+  {
+    // unique, so concurrent writers do not mix their output
+    fs::path tmp = path;
+    tmp += format(".{:08x}.tmp", std::random_device{}());
+    {
+      std::ofstream out(tmp.string(), std::ios::binary | std::ios::trunc);
+      if (!out)
+        throw std::runtime_error(format("cannot write {}", tmp.string()));
+      write(out);
+    }
+    fs::rename(tmp, path);
+  }
+
+  // MAPPEDFILE
+  //
+#ifdef _WIN32
+  MappedFile::MappedFile(fs::path const& path)
+  {
+    std::ifstream in(path.string(), std::ios::binary);
+    if (!in)
+      throw std::invalid_argument(format("could not open {}", path.string()));
+    buffer.assign(std::istreambuf_iterator<char>(in),
+        std::istreambuf_iterator<char>());
+    data = buffer.data();
+    size = buffer.size();
+  }
+
+  MappedFile::~MappedFile() {}
+#else
+  MappedFile::MappedFile(fs::path const& path)
+  {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+      throw std::invalid_argument(format("could not open {}", path.string()));
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0)
+    {
+      ::close(fd);
+      throw std::invalid_argument(format("could not read {}", path.string()));
+    }
+
+    size = st.st_size;
+    if (size > 0) // an empty mapping is an error
+    {
+      void* m = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (m == MAP_FAILED)
+      {
+        ::close(fd);
+        throw std::invalid_argument(format("could not map {}", path.string()));
+      }
+      ::madvise(m, size, MADV_SEQUENTIAL);
+      data = static_cast<char const*>(m);
+    }
+    ::close(fd); // the mapping stays valid
+  }
+
+  MappedFile::~MappedFile()
+  {
+    if (data)
+      ::munmap(const_cast<char*>(data), size);
+  }
+#endif
+
   // FOLDERSTRUCTURE
   //
   void FolderStructure::show(std::ostream& out) const
@@ -0,0 +1,32 @@
+#include "mic-mode.h"
+
+#include <fmt/core.h>
+#include <stdexcept>
+
+namespace pdr::mic
+{
+  MicMode mk_mode(std::string_view s)
+  {
+    if (s == plain_str)
+      return MicMode::plain;
+    if (s == ctg_str)
+      return MicMode::ctg;
+    if (s == ctg_adaptive_str)
+      return MicMode::ctg_adaptive;
+
+    throw std::invalid_argument(
+        fmt::format("\"{}\" is not a valid mic mode. expected {}, {} or {}", s,
+            plain_str, ctg_str, ctg_adaptive_str));
+  }
+
+  std::string to_string(MicMode m)
+  {
+    switch (m)
+    {
+      case MicMode::plain: return plain_str;
+      case MicMode::ctg: return ctg_str;
+      case MicMode::ctg_adaptive: return ctg_adaptive_str;
+      default: throw std::invalid_argument("pdr::MicMode is undefined");
+    }
+  }
+} // namespace pdr::mic
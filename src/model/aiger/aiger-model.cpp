@@ -0,0 +1,181 @@
+#include <climits>
+#include <fmt/core.h>
+#include <initializer_list>
+#include <stdexcept>
+#include <z3++.h>
+
+#include "aiger-model.h"
+#include "cli-parse.h"
+#include "z3-ext.h"
+
+namespace pdr::aiger
+{
+  using fmt::format;
+  using std::string;
+  using std::vector;
+  using z3::expr;
+  using z3::expr_vector;
+  using Aiger = parse::Aiger;
+
+  namespace
+  {
+    const string bad_name = "bad";
+
+    // add a clause to "cnf". constant literals are simplified away
+    void add_clause(expr_vector& cnf, expr_vector const& lits)
+    {
+      expr_vector clause(cnf.ctx());
+      for (expr const& l : lits)
+      {
+        if (l.is_true())
+          return;
+        if (!l.is_false())
+          clause.push_back(l);
+      }
+      cnf.push_back(z3::mk_or(clause));
+    }
+
+    void add_clause(expr_vector& cnf, std::initializer_list<expr> lits)
+    {
+      expr_vector clause(cnf.ctx());
+      for (expr const& l : lits)
+        clause.push_back(l);
+      add_clause(cnf, clause);
+    }
+  } // namespace
+
+  AigerModel::AigerModel(
+      const my::cli::ArgumentList& args, z3::context& c, const Aiger& aig)
+      : IModel(c, latch_names(aig)),
+        inputs(aig.inputs.size()),
+        latches(aig.latches.size()),
+        ands(aig.ands.size()),
+        var_map(aig.max_var + 1, c.bool_val(false))
+  {
+    name = my::cli::model_t::src_name(args.model);
+
+    for (size_t i{ 0 }; i < aig.inputs.size(); i++)
+      var_map.at(Aiger::var(aig.inputs[i])) =
+          ctx.bool_const(format("i{}", i).c_str());
+
+    for (size_t i{ 0 }; i < aig.latches.size(); i++)
+      var_map.at(Aiger::var(aig.latches[i].lit)) = vars(i);
+
+    for (Aiger::And const& a : aig.ands)
+      var_map.at(Aiger::var(a.lhs)) =
+          ctx.bool_const(format("a{}", Aiger::var(a.lhs)).c_str());
+
+    load_reset(aig);
+    load_aig_transition(aig);
+    load_property();
+  }
+
+  vector<string> AigerModel::latch_names(const Aiger& aig)
+  {
+    vector<string> rv;
+    rv.reserve(aig.latches.size() + 1);
+    for (size_t i{ 0 }; i < aig.latches.size(); i++)
+      rv.push_back(format("l{}", i));
+    rv.push_back(bad_name);
+
+    return rv;
+  }
+
+  expr AigerModel::lit(unsigned l) const
+  {
+    if (Aiger::var(l) == 0)
+      return ctx.bool_val(Aiger::sign(l));
+
+    expr const& v = var_map.at(Aiger::var(l));
+    return Aiger::sign(l) ? !v : v;
+  }
+
+  size_t AigerModel::n_inputs() const { return inputs; }
+  size_t AigerModel::n_latches() const { return latches; }
+  size_t AigerModel::n_ands() const { return ands; }
+
+  void AigerModel::load_reset(const Aiger& aig)
+  {
+    initial.resize(0);
+
+    for (size_t i{ 0 }; i < aig.latches.size(); i++)
+    {
+      Aiger::Latch const& l = aig.latches[i];
+      if (l.reset == 0)
+        initial.push_back(!vars(i));
+      else if (l.reset == 1)
+        initial.push_back(vars(i));
+      // else: reset == lit, uninitialized
+    }
+    initial.push_back(!vars(latches)); // bad
+  }
+
+  void AigerModel::load_aig_transition(const Aiger& aig)
+  {
+    transition.resize(0);
+
+    // g <-> rhs0 & rhs1. the order of the gates is irrelevant for the cnf
+    for (Aiger::And const& a : aig.ands)
+    {
+      // negate through the literal, so constants remain constants
+      expr g = lit(a.lhs);
+      add_clause(transition, { !g, lit(a.rhs0) });
+      add_clause(transition, { !g, lit(a.rhs1) });
+      add_clause(transition, { g, lit(a.rhs0 ^ 1), lit(a.rhs1 ^ 1) });
+    }
+
+    // l' <-> next(l)
+    for (size_t i{ 0 }; i < aig.latches.size(); i++)
+    {
+      unsigned next = aig.latches[i].next;
+      add_clause(transition, { !vars.p(i), lit(next) });
+      add_clause(transition, { vars.p(i), lit(next ^ 1) });
+    }
+
+    // invariant constraints restrict every step
+    for (unsigned c : aig.constraints)
+      add_clause(transition, { lit(c) });
+
+    // bad' <-> some bad literal holds now. outputs if there are no bad lits
+    vector<unsigned> const& bad_lits =
+        aig.bad.empty() ? aig.outputs : aig.bad;
+    if (bad_lits.empty())
+      throw std::invalid_argument(
+          "aiger model has neither bad states nor outputs to check");
+
+    expr bad_p = vars.p(latches);
+    expr_vector any_bad(ctx);
+    for (unsigned b : bad_lits)
+    {
+      add_clause(transition, { bad_p, lit(b ^ 1) });
+      any_bad.push_back(lit(b));
+    }
+    any_bad.push_back(!bad_p);
+    add_clause(transition, any_bad);
+  }
+
+  void AigerModel::load_property()
+  {
+    expr bad = vars(latches);
+
+    n_property.add(bad);
+    n_property.finish();
+
+    property.add(!bad);
+    property.finish();
+  }
+
+  const expr AigerModel::get_constraint_current() const
+  {
+    return ctx.bool_val(true);
+  }
+
+  unsigned AigerModel::state_size() const { return vars().size(); }
+
+  const std::string AigerModel::constraint_str() const
+  {
+    return "no constraint";
+  }
+
+  unsigned AigerModel::constraint_num() const { return UINT_MAX; }
+} // namespace pdr::aiger
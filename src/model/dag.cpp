@@ -1,6 +1,8 @@
 #include "dag.h"
+#include "graphvizgraph.h"
 #include "io.h"
 
+#include <algorithm>
 #include <fmt/ranges.h>
 #include <iostream>
 #include <map>
@@ -16,53 +18,25 @@ namespace dag
   using std::vector;
 
   Graph::Graph() {}
-  Graph::Graph(Graph const& G)
-  {
-    name        = G.name;
-    prefix      = G.prefix;
-    input       = G.input;
-    nodes       = G.nodes;
-    output      = G.output;
-    edges       = G.edges;
-    children    = G.children;
-    input_edges = G.input_edges;
-    empty_vec   = G.empty_vec;
-  }
   Graph::Graph(string const& s) : name(s) {}
-  Graph::Graph(string const& name, string const& dotstring)
-      : name(name), image(std::make_unique<graphviz::Graph>(dotstring))
+
+  Graph::Staging& Graph::staging()
   {
-    image->foreach_node(
-        [this](Agnode_t* node)
-        {
-          auto [name, type] = image->name_of(node);
-          switch (type)
-          {
-            case graphviz::XMGnode::pi: add_input(name); break;
-            case graphviz::XMGnode::po: break;
-            case graphviz::XMGnode::node: add_node(name);
-          }
-
-          vector<string> c = image->children_of(node);
-
-          if (type == graphviz::XMGnode::po)
-          {
-            assert(c.size() == 1);
-            add_output(c[0]);
-          }
-          else
-            add_edges_to(c, name);
-        });
+    assert(staged || names.empty()); // a built graph is read-only
+    if (!staged)
+      staged.emplace();
+    return *staged;
   }
 
-  void Graph::add_input(string iname) { input.insert(node(iname)); }
+  void Graph::add_input(string iname) { staging().input.insert(node(iname)); }
 
-  void Graph::add_node(string nname) { nodes.insert(node(nname)); }
+  void Graph::add_node(string nname) { staging().nodes.insert(node(nname)); }
 
   void Graph::add_output(string oname)
   {
-    nodes.insert(node(oname));
-    output.insert(node(oname));
+    Staging& s = staging();
+    s.nodes.insert(node(oname));
+    s.output.insert(node(oname));
   }
 
   void Graph::add_edges_to(vector<string> from, string to)
@@ -70,8 +44,9 @@ namespace dag
     if (from.empty())
       return;
 
-    to = node(to);
-    assert(nodes.find(to) != nodes.end());
+    Staging& s = staging();
+    to         = node(to);
+    assert(s.nodes.find(to) != s.nodes.end());
 
     vector<string> to_children;
     to_children.reserve(from.size());
@@ -79,48 +54,183 @@ namespace dag
     for (string i : from)
     {
       string n = node(i);
-      if (input.find(n) != input.end())
+      if (s.input.find(n) != s.input.end())
       {
-        input_edges.emplace(n, to);
+        s.input_edges.emplace_back(n, to);
         continue;
       }
 
-      assert(nodes.find(n) != nodes.end());
-      edges.emplace(n, to);
+      assert(s.nodes.find(n) != s.nodes.end());
       to_children.push_back(n);
     }
 
-    children.emplace(to, std::move(to_children));
+    s.children.emplace(to, std::move(to_children));
+  }
+
+  void Graph::build()
+  {
+    if (!staged)
+      return;
+    Staging s = std::move(*staged);
+    staged.reset();
+
+    names.assign(s.nodes.begin(), s.nodes.end());
+    inputs.assign(s.input.begin(), s.input.end());
+    const size_t n = names.size();
+
+    auto index_of = [](vector<string> const& sorted, string const& name)
+    {
+      auto i = std::lower_bound(sorted.begin(), sorted.end(), name);
+      assert(i != sorted.end() && *i == name);
+      return static_cast<node_t>(i - sorted.begin());
+    };
+
+    offsets.assign(n + 1, 0);
+    targets.clear();
+    // seen[c] == i + 1 if c is already a child of i
+    vector<node_t> seen(n, 0);
+    for (node_t i = 0; i < n; i++)
+    {
+      offsets[i] = targets.size();
+      auto c     = s.children.find(names[i]);
+      if (c == s.children.end())
+        continue;
+      for (string const& child : c->second)
+      {
+        node_t c_id = index_of(names, child);
+        if (seen[c_id] != i + 1)
+        {
+          seen[c_id] = i + 1;
+          targets.push_back(c_id);
+        }
+      }
+    }
+    offsets[n] = targets.size();
+    targets.shrink_to_fit();
+
+    output_flags.assign(n, false);
+    output_ids.clear();
+    for (string const& o : s.output)
+    {
+      node_t o_id = index_of(names, o);
+      output_flags[o_id] = true;
+      output_ids.push_back(o_id);
+    }
+    std::sort(output_ids.begin(), output_ids.end());
+
+    input_edges.clear();
+    for (auto const& [from, to] : s.input_edges)
+      input_edges.emplace_back(index_of(inputs, from), index_of(names, to));
+    std::sort(input_edges.begin(), input_edges.end());
+    input_edges.erase(std::unique(input_edges.begin(), input_edges.end()),
+        input_edges.end());
+  }
+
+  std::optional<node_t> Graph::find(std::string_view name) const
+  {
+    auto i = std::lower_bound(names.begin(), names.end(), name);
+    if (i == names.end() || *i != name)
+      return {};
+    return static_cast<node_t>(i - names.begin());
+  }
+
+  Graph Graph::reduced() const
+  {
+    assert(is_built());
+    const size_t n = n_nodes();
+
+    // cone of influence of the outputs
+    vector<bool> cone(n, false);
+    vector<node_t> todo(output_ids.begin(), output_ids.end());
+    while (!todo.empty())
+    {
+      node_t i = todo.back();
+      todo.pop_back();
+      if (cone[i])
+        continue;
+      cone[i] = true;
+      for (node_t c : children(i))
+        todo.push_back(c);
+    }
+
+    std::map<node_t, vector<string>> from_inputs;
+    for (auto const& [in, to] : input_edges)
+      if (cone[to])
+        from_inputs[to].push_back(inputs[in]);
+
+    Graph rv(name);
+    for (auto const& [to, from] : from_inputs)
+      for (string const& i : from)
+        rv.add_input(i);
+
+    // constants stay nodes: they are pebbled like any other node
+    vector<node_t> kept;
+    for (node_t i = 0; i < n; i++)
+    {
+      if (!cone[i])
+        continue;
+      rv.add_node(names[i]);
+      kept.push_back(i);
+    }
+    for (node_t o : output_ids)
+      rv.add_output(names[o]);
+
+    for (node_t i : kept)
+    {
+      vector<string> from;
+      for (node_t c : children(i))
+        from.push_back(names[c]);
+      auto in = from_inputs.find(i);
+      if (in != from_inputs.end())
+        from.insert(from.end(), in->second.begin(), in->second.end());
+      rv.add_edges_to(from, names[i]);
+    }
+
+    rv.build();
+    rv.prefix = prefix;
+    return rv;
   }
 
   string Graph::summary() const
   {
     return fmt::format("Graph {{ In: {}, Out {}, Nodes {}, Edges {} }}",
-        input.size(), output.size(), nodes.size(), edges.size());
+        n_inputs(), n_outputs(), n_nodes(), n_edges());
   }
 
   std::string Graph::DAG_string() const
   {
+    vector<string> output_names, edges;
+    for (node_t o : output_ids)
+      output_names.push_back(names[o]);
+    for (node_t i = 0; i < n_nodes(); i++)
+      for (node_t c : children(i))
+        edges.push_back(fmt::format("({}, {})", names[c], names[i]));
+
     std::stringstream ss;
     ss << "DAG \{" << endl
-       << fmt::format("\tinput {}", input) << endl
-       << fmt::format("\toutput {}", output) << " }" << endl
-       << fmt::format("\tnodes {}", nodes) << " }" << endl
+       << fmt::format("\tinput {}", inputs) << endl
+       << fmt::format("\toutput {}", output_names) << " }" << endl
+       << fmt::format("\tnodes {}", names) << " }" << endl
        << fmt::format("\tedges {}", edges) << " }" << endl
        << "}" << endl;
     return ss.str();
   }
 
-  void Graph::show_image(string const& destination)
+  void Graph::show_image(string const& destination) const
   {
-    if (!image)
-      image = std::make_unique<graphviz::Graph>(dot());
-    image->render(destination);
+    // the layout is not kept, it is only needed for this image
+    graphviz::Graph(dot()).render(destination);
   }
 
-  void Graph::show(string const& destination, bool to_cout, bool brief)
+  void Graph::show(string const& destination, bool to_cout, bool brief) const
   {
     show_image(destination);
+    describe(destination, to_cout, brief);
+  }
+
+  void Graph::describe(
+      string const& destination, bool to_cout, bool brief) const
+  {
     std::ofstream out = my::io::trunc_file(destination + ".txt");
     if (to_cout)
     {
@@ -129,41 +239,27 @@ namespace dag
         std::cout << endl << DAG_string() << endl;
     }
     out << summary() << endl;
-      if (!brief)
-        out << endl << DAG_string() << endl;
+    if (!brief)
+      out << endl << DAG_string() << endl;
   }
 
-  string Graph::dot()
+  string Graph::dot() const
   {
     std::stringstream ss;
     ss << "digraph G {" << endl;
 
-    for (Edge const& e : input_edges)
-      ss << fmt::format("{} -> {};", e.from, e.to) << endl;
-    for (Edge const& e : edges)
-      ss << fmt::format("{} -> {};", e.from, e.to) << endl;
+    for (auto const& [in, to] : input_edges)
+      ss << fmt::format("{} -> {};", inputs[in], names[to]) << endl;
+    for (node_t i = 0; i < n_nodes(); i++)
+      for (node_t c : children(i))
+        ss << fmt::format("{} -> {};", names[c], names[i]) << endl;
 
-    for (string const& o : input)
+    for (string const& o : inputs)
       ss << fmt::format("{} [shape=plain];", o) << endl;
-    for (string const& o : output)
-      ss << fmt::format("{} [shape=doublecircle];", o) << endl;
+    for (node_t o : output_ids)
+      ss << fmt::format("{} [shape=doublecircle];", names[o]) << endl;
 
     ss << "}" << endl;
     return ss.str();
   }
-
-  bool Graph::is_output(std::string_view name) const
-  {
-    return output.find(name) != output.end();
-  }
-
-  vector<string> const& Graph::get_children(std::string_view key) const
-  {
-    auto result = children.find(key);
-
-    if (result == children.end())
-      return empty_vec;
-
-    return result->second;
-  }
 } // namespace dag
@@ -1,11 +1,11 @@
 #include "expr.h"
 #include "z3-ext.h"
+#include <algorithm>
 #include <cassert>
 #include <cstdlib>
 #include <fmt/core.h>
 #include <iostream>
 #include <optional>
-#include <regex>
 #include <stdexcept>
 #include <z3++.h>
 
@@ -58,34 +58,17 @@ namespace mysat::primed
 
   bool Lit::extract_value(const z3::expr_vector& cube, lit_type t) const
   {
-    // matches name[i], extracts name and i
-    std::regex is_value;
-    string match_name;
-    if (t == lit_type::primed)
-    {
-      is_value   = next_name;
-      match_name = next_name;
-    }
-    else
-    {
-      is_value   = fmt::format("{}(?!.p)", name); // name not followed by .p
-      match_name = name;
-    }
-
+    const unsigned id = get(t).id();
     std::optional<bool> v;
 
     for (const expr& l : cube)
     {
       assert(z3ext::is_lit(l));
-      std::smatch match;
-      string l_str = l.to_string();
-      if (std::regex_search(l_str, match, is_value))
+      if (strip_not(l).id() == id)
       {
-        assert(match.size() == 1);
         // no contradicting literals
         assert(not v.has_value() || (v == not l.is_not()));
         v = not l.is_not();
-        // }
       }
     }
 
@@ -120,6 +103,7 @@ namespace mysat::primed
       to_current.emplace(new_next.id(), current.size() - 1);
       to_next.emplace(new_curr.id(), next.size() - 1);
     }
+    order();
   }
 
   void VarVec::add(
@@ -142,6 +126,7 @@ namespace mysat::primed
       to_current.emplace(new_next.id(), current.size() - 1);
       to_next.emplace(new_curr.id(), next.size() - 1);
     }
+    order();
   }
 
   VarVec::operator const expr_vector&() const { return current; }
@@ -228,6 +213,44 @@ namespace mysat::primed
     return rv;
   }
 
+  void VarVec::order()
+  {
+    auto mk_ordered = [](expr_vector const& vars)
+    {
+      // the negations are kept alive here, so their ids stay fixed
+      vector<OrderedLit> rv;
+      rv.reserve(2 * vars.size());
+      for (size_t i{ 0 }; i < vars.size(); i++)
+      {
+        rv.push_back({ vars[i], i, true });
+        rv.push_back({ !vars[i], i, false });
+      }
+      std::sort(rv.begin(), rv.end(),
+          [](OrderedLit const& a, OrderedLit const& b)
+          { return z3ext::cube_orderer(a.lit, b.lit); });
+      return rv;
+    };
+    ordered_current = mk_ordered(current);
+    ordered_next    = mk_ordered(next);
+  }
+
+  vector<expr> VarVec::ordered_cube(
+      vector<std::optional<bool>> const& values, lit_type t) const
+  {
+    vector<OrderedLit> const& ordered =
+        t == lit_type::base ? ordered_current : ordered_next;
+    assert(values.size() == get(t).size());
+
+    vector<expr> rv;
+    rv.reserve(values.size());
+    for (OrderedLit const& l : ordered)
+      if (values[l.index] == l.value)
+        rv.push_back(l.lit);
+
+    assert(z3ext::lits_ordered(rv));
+    return rv;
+  }
+
   bool VarVec::lit_is_current(const z3::expr& e) const
   {
     expr key = strip_not(e);
@@ -323,6 +346,8 @@ namespace mysat::primed
     {
       current.push_back(ctx.bool_const(index_str(name, i).c_str()));
       next.push_back(ctx.bool_const(index_str(next_name, i).c_str()));
+      bit_index.emplace(current.back().id(), i);
+      bit_index.emplace(next.back().id(), i);
     }
   }
 
@@ -379,26 +404,71 @@ namespace mysat::primed
       const expr_vector& cube, const lit_type t) const
   {
     std::bitset<MAX_BITS> n;
-    const string match_name{ t == lit_type::primed ? next_name : name };
-    // matches name__i, extracts i
-    const std::regex is_value{ fmt::format("{}__([[:digit:]]+)", match_name) };
+    const expr_vector& bits = get(t);
 
     for (const expr& l : cube)
     {
       assert(z3ext::is_lit(l)); // vector represents a cube
-      std::smatch match;
-      const string l_str = l.to_string();
-      if (std::regex_search(l_str, match, is_value))
-      {
-        assert(match.size() == 2);
-        const numrep_t i = std::stoul(match[1]);
-        n.set(i, !l.is_not());
-      }
+      const unsigned id = strip_not(l).id();
+      auto index        = bit_index.find(id);
+      // the map holds both states, only take bits of type t
+      if (index != bit_index.end() && bits[index->second].id() == id)
+        n.set(index->second, !l.is_not());
     }
 
     return n.to_ulong();
   }
 
+  // SymbolTable
+  //
+  unsigned SymbolTable::add(BitVec const& v)
+  {
+    unsigned owner = n_owners++;
+    for (unsigned i = 0; i < v.size; i++)
+    {
+      symbols.insert_or_assign(v(i).id(), Symbol{ owner, i, lit_type::base });
+      symbols.insert_or_assign(v.p(i).id(), Symbol{ owner, i, lit_type::primed });
+    }
+    return owner;
+  }
+
+  unsigned SymbolTable::add(Lit const& v)
+  {
+    unsigned owner = n_owners++;
+    symbols.insert_or_assign(v().id(), Symbol{ owner, 0, lit_type::base });
+    symbols.insert_or_assign(v.p().id(), Symbol{ owner, 0, lit_type::primed });
+    return owner;
+  }
+
+  Symbol const* SymbolTable::find(expr const& lit) const
+  {
+    auto it = symbols.find(strip_not(lit).id());
+    if (it == symbols.end())
+      return nullptr;
+    return &it->second;
+  }
+
+  size_t SymbolTable::size() const { return n_owners; }
+
+  vector<SymbolTable::numrep_t> SymbolTable::decode(
+      expr_vector const& cube, lit_type t) const
+  {
+    vector<numrep_t> values(n_owners, 0);
+    for (expr const& l : cube)
+    {
+      assert(z3ext::is_lit(l)); // vector represents a cube
+      Symbol const* s = find(l);
+      if (!s || s->type != t)
+        continue;
+
+      if (l.is_not())
+        values[s->owner] &= ~(numrep_t(1) << s->bit);
+      else
+        values[s->owner] |= numrep_t(1) << s->bit;
+    }
+    return values;
+  }
+
   namespace
   {
     // equality for literals
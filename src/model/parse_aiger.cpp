@@ -0,0 +1,205 @@
+#include "parse_aiger.h"
+
+#include <cassert>
+#include <fmt/core.h>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace parse
+{
+  using fmt::format;
+  using std::invalid_argument;
+  using std::string;
+  using std::string_view;
+  using std::vector;
+
+  namespace
+  {
+    struct Header
+    {
+      bool binary;
+      unsigned M, I, L, O, A;
+      unsigned B{ 0 }, C{ 0 }, J{ 0 }, F{ 0 };
+    };
+
+    invalid_argument malformed(string const& filename, string_view what)
+    {
+      return invalid_argument(
+          format("{} is not a valid aiger file: {}", filename, what));
+    }
+
+    Header read_header(std::istream& in, string const& filename)
+    {
+      string line;
+      if (!std::getline(in, line))
+        throw malformed(filename, "missing header");
+
+      std::istringstream ss(line);
+      string tag;
+      Header h;
+      ss >> tag >> h.M >> h.I >> h.L >> h.O >> h.A;
+      if (!ss || (tag != "aig" && tag != "aag"))
+        throw malformed(filename, format("invalid header \"{}\"", line));
+      h.binary = tag == "aig";
+      // optional aiger 1.9 fields
+      ss >> h.B >> h.C >> h.J >> h.F;
+
+      if (h.M < h.I + h.L + h.A || (h.binary && h.M != h.I + h.L + h.A))
+        throw malformed(filename, "inconsistent M I L A in header");
+
+      return h;
+    }
+
+    // read a line of unsigned literals. at least "min" and at most "max"
+    vector<unsigned> read_line(std::istream& in, Header const& h,
+        string const& filename, size_t min, size_t max)
+    {
+      string line;
+      if (!std::getline(in, line))
+        throw malformed(filename, "unexpected end of file");
+
+      vector<unsigned> rv;
+      std::istringstream ss(line);
+      unsigned x;
+      while (ss >> x)
+      {
+        if (x > 2 * h.M + 1)
+          throw malformed(filename, format("literal {} exceeds M", x));
+        rv.push_back(x);
+      }
+
+      if (rv.size() < min || rv.size() > max)
+        throw malformed(filename, format("invalid line \"{}\"", line));
+
+      return rv;
+    }
+
+    unsigned read_lit(std::istream& in, Header const& h, string const& f)
+    {
+      return read_line(in, h, f, 1, 1)[0];
+    }
+
+    // inputs, latches and and-gates must define a positive, unnegated literal
+    void check_defined(unsigned lit, string const& filename, string_view what)
+    {
+      if (lit < 2 || Aiger::sign(lit))
+        throw malformed(filename, format("invalid {} literal {}", what, lit));
+    }
+
+    // binary and-gates store deltas as 7-bit chunks, lsb first
+    unsigned read_delta(std::istream& in, string const& filename)
+    {
+      unsigned x{ 0 }, shift{ 0 };
+      int c;
+      do
+      {
+        if (shift >= 32)
+          throw malformed(filename, "and-gate delta exceeds 32 bits");
+        c = in.get();
+        if (c == EOF)
+          throw malformed(filename, "unexpected end of and-gates");
+        unsigned chunk = c & 0x7f;
+        if (shift > 0 && (chunk >> (32 - shift)) != 0)
+          throw malformed(filename, "and-gate delta exceeds 32 bits");
+        x |= chunk << shift;
+        shift += 7;
+      } while (c & 0x80);
+
+      return x;
+    }
+  } // namespace
+
+  Aiger read_aiger(string const& filename)
+  {
+    std::ifstream in(filename, std::ios::in | std::ios::binary);
+    if (!in.is_open())
+      throw invalid_argument(format("could not open {}", filename));
+
+    Header h = read_header(in, filename);
+    Aiger aig;
+    aig.max_var = h.M;
+
+    aig.inputs.reserve(h.I);
+    for (unsigned i{ 0 }; i < h.I; i++)
+    {
+      if (h.binary)
+        aig.inputs.push_back(2 * (i + 1));
+      else
+      {
+        unsigned lit = read_lit(in, h, filename);
+        check_defined(lit, filename, "input");
+        aig.inputs.push_back(lit);
+      }
+    }
+
+    aig.latches.reserve(h.L);
+    for (unsigned i{ 0 }; i < h.L; i++)
+    {
+      Aiger::Latch l;
+      vector<unsigned> line;
+      if (h.binary)
+      {
+        line  = read_line(in, h, filename, 1, 2);
+        l.lit = 2 * (h.I + i + 1);
+      }
+      else
+      {
+        line = read_line(in, h, filename, 2, 3);
+        l.lit = line[0];
+        line.erase(line.begin());
+        check_defined(l.lit, filename, "latch");
+      }
+      l.next  = line[0];
+      l.reset = line.size() > 1 ? line[1] : 0;
+      if (l.reset != 0 && l.reset != 1 && l.reset != l.lit)
+        throw malformed(filename, format("invalid reset for latch {}", l.lit));
+      aig.latches.push_back(l);
+    }
+
+    for (unsigned i{ 0 }; i < h.O; i++)
+      aig.outputs.push_back(read_lit(in, h, filename));
+    for (unsigned i{ 0 }; i < h.B; i++)
+      aig.bad.push_back(read_lit(in, h, filename));
+    for (unsigned i{ 0 }; i < h.C; i++)
+      aig.constraints.push_back(read_lit(in, h, filename));
+
+    // liveness properties are not supported, skip them
+    vector<unsigned> justice_sizes;
+    for (unsigned i{ 0 }; i < h.J; i++)
+      justice_sizes.push_back(read_lit(in, h, filename));
+    for (unsigned size : justice_sizes)
+      for (unsigned i{ 0 }; i < size; i++)
+        read_lit(in, h, filename);
+    for (unsigned i{ 0 }; i < h.F; i++)
+      read_lit(in, h, filename);
+
+    aig.ands.reserve(h.A);
+    for (unsigned i{ 0 }; i < h.A; i++)
+    {
+      Aiger::And a;
+      if (h.binary)
+      {
+        a.lhs  = 2 * (h.I + h.L + i + 1);
+        a.rhs0 = a.lhs - read_delta(in, filename);
+        a.rhs1 = a.rhs0 - read_delta(in, filename);
+        if (a.rhs0 >= a.lhs || a.rhs1 > a.rhs0)
+          throw malformed(filename, format("invalid and-gate {}", a.lhs));
+      }
+      else
+      {
+        vector<unsigned> line = read_line(in, h, filename, 3, 3);
+        a = { line[0], line[1], line[2] };
+      }
+
+      check_defined(a.lhs, filename, "and-gate");
+      aig.ands.push_back(a);
+    }
+    // symbol table and comments are ignored
+
+    return aig;
+  }
+} // namespace parse
@@ -0,0 +1,134 @@
+#include "parse_bench.h"
+#include "io.h"
+#include "parse_text.h"
+
+#include <fmt/core.h>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace parse
+{
+  using fmt::format;
+  using std::string;
+  using std::string_view;
+  using std::vector;
+
+  namespace
+  {
+    struct Gate
+    {
+      string_view name;
+      vector<string_view> operands;
+      unsigned line;
+    };
+
+    // "INPUT(" or "OUTPUT(", with optional spaces before the bracket
+    bool keyword(string_view line, string_view key)
+    {
+      return starts_with(line, key) &&
+             starts_with(trim(line.substr(key.size())), "(");
+    }
+  } // namespace
+
+  dag::Graph read_bench(string const& filename, string const& graph_name)
+  {
+    my::io::MappedFile file(filename);
+    Lines lines(filename, file.text());
+
+    // the comma-separated names between the brackets in s
+    auto operands = [&lines](string_view s)
+    {
+      size_t open = s.find('(');
+      if (open == string_view::npos)
+        throw lines.error("'(' expected", s);
+      size_t close = s.find(')', open);
+      if (close == string_view::npos)
+        throw lines.error("')' expected", s.substr(s.size()));
+
+      string_view list = s.substr(open + 1, close - open - 1);
+      vector<string_view> rv;
+      while (!list.empty())
+      {
+        string_view name = next_token(list, ',');
+        if (name.empty())
+          throw lines.error("empty operand", name);
+        rv.push_back(name);
+      }
+      return rv;
+    };
+    auto single = [&](string_view s, string_view what)
+    {
+      vector<string_view> args = operands(s);
+      if (args.size() != 1)
+        throw lines.error(format("{} must have 1 argument", what), s);
+      return args[0];
+    };
+
+    // all names are views into the file. gates may be used before they are
+    // defined, so the graph is only filled after reading everything
+    vector<string_view> inputs;
+    vector<std::pair<string_view, unsigned>> outputs;
+    vector<Gate> gates;
+    string_view line;
+    while (lines.next(line))
+    {
+      if (keyword(line, "INPUT"))
+        inputs.push_back(single(line.substr(5), "INPUT"));
+      else if (keyword(line, "OUTPUT"))
+        outputs.emplace_back(single(line.substr(6), "OUTPUT"), lines.line());
+      else
+      {
+        size_t eq = line.find('=');
+        if (eq == string_view::npos)
+          throw lines.error("expected INPUT, OUTPUT or a gate", line);
+        Gate g{ trim(line.substr(0, eq)), operands(line.substr(eq + 1)),
+          lines.line() };
+        if (g.name.empty())
+          throw lines.error("gate without a name", line);
+        if (g.operands.empty())
+          throw lines.error("gate without operands", line.substr(eq + 1));
+        gates.push_back(std::move(g));
+      }
+    }
+
+    std::unordered_set<string_view> defined(inputs.begin(), inputs.end());
+    for (Gate const& g : gates)
+      defined.insert(g.name);
+    auto check = [&](string_view name, unsigned line_no)
+    {
+      if (defined.find(name) == defined.end())
+        throw std::invalid_argument(format(
+            "{}:{}: {} is used but never defined", filename, line_no, name));
+    };
+
+    dag::Graph G(graph_name);
+    G.prefix = "n_";
+    for (string_view i : inputs)
+      G.add_input(string(i));
+    for (Gate const& g : gates)
+      G.add_node(string(g.name));
+    for (auto const& [o, line_no] : outputs)
+    {
+      check(o, line_no);
+      G.add_output(string(o));
+    }
+    for (Gate const& g : gates)
+    {
+      vector<string> children;
+      children.reserve(g.operands.size());
+      for (string_view o : g.operands)
+      {
+        check(o, g.line);
+        children.emplace_back(o);
+      }
+      G.add_edges_to(children, string(g.name));
+    }
+
+    G.build();
+    return G;
+  }
+} // namespace parse
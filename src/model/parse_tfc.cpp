@@ -0,0 +1,141 @@
+#include "parse_tfc.h"
+#include "io.h"
+#include "parse_text.h"
+
+#include <fmt/core.h>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace parse
+{
+  using fmt::format;
+  using std::string;
+  using std::string_view;
+  using std::vector;
+
+  namespace
+  {
+    string node(string_view name, unsigned version)
+    {
+      return format("{}_{}", name, version);
+    }
+  } // namespace
+
+  dag::Graph read_tfc(string const& filename, string const& graph_name)
+  {
+    my::io::MappedFile file(filename);
+    Lines lines(filename, file.text());
+    dag::Graph G(graph_name);
+
+    // the current version of every wire. keys are views into the file
+    std::unordered_map<string_view, unsigned> vars;
+    vector<string_view> outs;
+
+    string_view line;
+    auto next_line = [&](string_view expected)
+    {
+      if (!lines.next(line))
+        throw lines.error(format("expected \"{}\" before the end", expected));
+    };
+    // the rest of the line after "key"
+    auto after = [&](string_view key) -> string_view
+    {
+      if (!starts_with(line, key))
+        throw lines.error(format("expected \"{}\"", key), line);
+      return line.substr(key.size());
+    };
+    // the comma-separated names in "list"
+    auto names = [&](string_view list)
+    {
+      vector<string_view> rv;
+      while (!list.empty())
+      {
+        string_view name = next_token(list, ',');
+        if (name.empty())
+          throw lines.error("empty name", name);
+        rv.push_back(name);
+      }
+      return rv;
+    };
+    auto input = [&](string_view name)
+    {
+      vars.emplace(name, 0);
+      G.add_input(node(name, 0));
+      return node(name, 0);
+    };
+
+    next_line(".v");
+    after(".v ");
+    next_line(".i");
+    for (string_view name : names(after(".i ")))
+      input(name);
+    next_line(".o");
+    outs = names(after(".o "));
+
+    next_line("BEGIN");
+    if (starts_with(line, ".ol ")) // optional
+      next_line("BEGIN");
+    if (starts_with(line, ".c ")) // optional
+      next_line("BEGIN");
+    after("BEGIN");
+
+    while (true)
+    {
+      next_line("END");
+      if (line == "END")
+        break;
+
+      // <gate> <controls>,<target>
+      string_view operands = line;
+      size_t space         = operands.find_first_of(" \t");
+      if (space == string_view::npos)
+        throw lines.error("expected operands", line.substr(line.size()));
+      operands.remove_prefix(space);
+      vector<string_view> wires = names(operands);
+
+      string_view target = wires.back();
+      wires.pop_back();
+      string old_t, new_t;
+      if (auto t = vars.find(target); t != vars.end())
+      {
+        old_t = node(target, t->second);
+        new_t = node(target, ++t->second);
+      }
+      else
+      {
+        vars.emplace(target, 0);
+        new_t = node(target, 0);
+      }
+      G.add_node(new_t);
+
+      vector<string> children;
+      children.reserve(wires.size() + 1);
+      for (string_view w : wires)
+      {
+        auto found = vars.find(w);
+        if (found == vars.end()) // a constant starting value
+          children.push_back(input(w));
+        else
+          children.push_back(node(w, found->second));
+      }
+      if (!old_t.empty())
+        children.push_back(old_t);
+
+      G.add_edges_to(children, new_t);
+    }
+
+    for (string_view o : outs)
+    {
+      auto found = vars.find(o);
+      if (found == vars.end())
+        throw lines.error(format("output {} is not a wire", o));
+      // name of latest version static single assignment form
+      G.add_output(node(o, found->second));
+    }
+
+    G.build();
+    return G;
+  }
+} // namespace parse
@@ -10,10 +10,14 @@
 #include <variant>
 
 #define SKIP_BLOCKED_DEFAULT true
+#define LIFT_DEFAULT true
+#define SYMMETRY_DEFAULT true
 #define MIC_RETRIES_DEFAULT UINT_MAX
+#define MIC_MODE_DEFAULT MicMode::plain
 #define CTG_MAX_DEPTH_DEFAULT 1
 #define CTG_MAX_COUNTERS_DEFAULT 3
 #define SUBSUMED_CUT_DEFEAULT 0.5
+#define PROPAGATION_THREADS_DEFAULT 1
 
 namespace pdr
 {
@@ -24,11 +28,18 @@ namespace pdr
     part_min_core    = false;
     type             = Tactic::undef;
     skip_blocked     = args.skip_blocked.value_or(SKIP_BLOCKED_DEFAULT);
+    lift             = args.lift.value_or(LIFT_DEFAULT);
+    symmetry         = args.symmetry.value_or(SYMMETRY_DEFAULT);
     mic_retries      = args.mic_retries.value_or(MIC_RETRIES_DEFAULT);
+    mic              = args.mic_mode.value_or(MIC_MODE_DEFAULT);
     subsumed_cutoff  = args.subsumed_cutoff.value_or(SUBSUMED_CUT_DEFEAULT);
     ctg_max_depth    = args.ctg_max_depth.value_or(CTG_MAX_DEPTH_DEFAULT);
     ctg_max_counters = args.ctg_max_counters.value_or(CTG_MAX_COUNTERS_DEFAULT);
     simple_relax     = args.simple_relax;
+    cdcl             = args.cdcl;
+    propagation_threads =
+        args.propagation_threads.value_or(PROPAGATION_THREADS_DEFAULT);
+    lemma_cache = args.lemma_cache;
 
     z3_ctx.set("unsat_core", true);
     z3_ctx.set("model", true);
@@ -73,11 +84,45 @@ namespace pdr
     std::cout << settings_str() << std::endl;
   }
 
+  Context::Context(z3::context& c, Context const& settings)
+      : z3_ctx(c),
+        min_core(settings.min_core),
+        part_min_core(settings.part_min_core),
+        seed(settings.seed),
+        type(settings.type),
+        skip_blocked(settings.skip_blocked),
+        lift(settings.lift),
+        symmetry(settings.symmetry),
+        mic_retries(settings.mic_retries),
+        mic(settings.mic),
+        subsumed_cutoff(settings.subsumed_cutoff),
+        ctg_max_depth(settings.ctg_max_depth),
+        ctg_max_counters(settings.ctg_max_counters),
+        simple_relax(settings.simple_relax),
+        cdcl(settings.cdcl),
+        interrupt(settings.interrupt),
+        lemmas(settings.lemmas),
+        propagation_threads(settings.propagation_threads),
+        lemma_cache(settings.lemma_cache)
+  {
+    z3_ctx.set("unsat_core", true);
+    z3_ctx.set("model", true);
+    if (min_core)
+      z3_ctx.set("sat.core.minimize", true);
+    if (part_min_core)
+      z3_ctx.set("sat.core.minimize_partial", true);
+  }
+
   Context::operator z3::context&() { return z3_ctx; }
   Context::operator const z3::context&() const { return z3_ctx; }
 
   z3::context& Context::operator()() { return z3_ctx; }
 
+  bool Context::interrupted() const
+  {
+    return interrupt && interrupt->load(std::memory_order_relaxed);
+  }
+
   std::string Context::settings_str() const
   {
     using fmt::format;
@@ -90,12 +135,20 @@ namespace pdr
        << format("\tmin_core: {}", min_core) << endl
        << format("\tpart_min_core: {}", part_min_core) << endl
        << format("\tskip_blocked: {}", skip_blocked ? "true" : "false") << endl
+       << format("\tlift: {}", lift ? "true" : "false") << endl
+       << format("\tsymmetry: {}", symmetry ? "true" : "false") << endl
        << format("\tmic_retries: {}", mic_retries) << endl
+       << format("\tmic: {}", pdr::mic::to_string(mic)) << endl
        << format("\tsubsumed_cutoff: {}", subsumed_cutoff) << endl
        << format("\tctg_max_depth: {}", ctg_max_depth) << endl
        << format("\tctg_max_counters: {}", ctg_max_counters) << endl
        << format("\tseed: {}", seed) << endl
        << format("\tsimple_relax: {}", simple_relax) << endl
+       << format("\tsat backend: {}", cdcl ? "cdcl" : "z3") << endl
+       << format("\tpropagation_threads: {}", propagation_threads) << endl
+       << format("\tlemma_cache: {}",
+              lemma_cache ? lemma_cache->string() : "none")
+       << endl
        << "-------------";
 
     return ss.str();
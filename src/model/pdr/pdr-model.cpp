@@ -27,6 +27,7 @@ namespace pdr
         initial(ctx),
         transition(ctx),
         constraint(ctx),
+        constraint_assumptions(ctx),
         state_sorts(ctx)
   {
   }
@@ -35,6 +36,20 @@ namespace pdr
   const expr_vector& IModel::get_initial() const { return initial; }
   const expr_vector& IModel::get_transition() const { return transition; }
   const expr_vector& IModel::get_constraint() const { return constraint; }
+  const expr_vector& IModel::get_constraint_assumptions() const
+  {
+    return constraint_assumptions;
+  }
+
+  vector<expr> IModel::lift(vector<expr> const& pred, vector<expr> const&) const
+  {
+    return pred;
+  }
+
+  vector<vector<expr>> IModel::symmetric(vector<expr> const&) const
+  {
+    return {};
+  }
 
   // fixedpoint interface
   //
@@ -170,7 +185,6 @@ namespace pdr
   {
     using tabulate::Table;
     using z3ext::LitStr;
-    using namespace str::ext;
 
     vector<vector<LitStr>> rv;
     const vector<string> header = vars.names();
@@ -184,35 +198,25 @@ namespace pdr
           fmt::format("\"{}\" is not a valid state in the trace", s));
     };
 
-    // use regex to extract the assignments of "true" and "false" from a state
+    // a state is the application (state b0 b1 ...) of boolean constants
     // they are in order of ts.vars.names()
-    const std::regex marking(R"(\(state((?:\s+(?:true|false))*)\))");
-    std::smatch match;
-
     for (size_t i{ 0 }; i < states.size(); i++)
     {
-      string state_str(states[i].to_string());
-      if (!std::regex_match(state_str, match, marking))
-        throw invalid(state_str);
-      assert(match.size() == 2);
-
-      string mark_string = match[1];
-      trim(mark_string); // remove white spaces at beginning and end
-      // replace all white spaces by " "
-      mark_string = std::regex_replace(mark_string, std::regex("\\s+"), " ");
-
-      vector<string> marks = split(mark_string, ' ');
+      expr const& s = states[i];
+      if (!s.is_app() || s.decl().name().str() != "state" ||
+          s.num_args() != header.size())
+        throw invalid(s.to_string());
 
-      assert(marks.size() == header.size());
       vector<LitStr> state;
-      for (size_t j{ 0 }; j < marks.size(); j++)
+      for (unsigned j{ 0 }; j < s.num_args(); j++)
       {
-        if (marks[j] == "true")
+        expr mark = s.arg(j);
+        if (mark.is_true())
           state.emplace_back(header.at(j), true);
-        else if (marks[j] == "false")
+        else if (mark.is_false())
           state.emplace_back(header.at(j), false);
         else
-          throw invalid(state_str);
+          throw invalid(s.to_string());
       }
       rv.push_back(state);
     }
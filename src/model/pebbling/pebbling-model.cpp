@@ -1,4 +1,6 @@
 #include <TextTable.h>
+#include <algorithm>
+#include <cassert>
 #include <climits>
 #include <numeric>
 #include <optional>
@@ -7,6 +9,7 @@
 
 #include "cli-parse.h"
 #include "pebbling-model.h"
+#include "tseytin.h"
 #include "z3-ext.h"
 
 namespace pdr::pebbling
@@ -17,8 +20,10 @@ namespace pdr::pebbling
 
   PebblingModel::PebblingModel(
       const my::cli::ArgumentList& args, z3::context& c, const dag::Graph& G)
-      : IModel(c, std::vector<string>(G.nodes.begin(), G.nodes.end())), dag(G)
+      : IModel(c, G.nodes()), dag(G)
   {
+    // node i of the graph is state variable i
+    assert(G.is_built());
     name = my::cli::model_t::src_name(args.model);
 
     for (expr const& e : vars())
@@ -29,8 +34,9 @@ namespace pdr::pebbling
     else
       load_pebble_transition(G);
 
-    final_pebbles = G.output.size();
+    final_pebbles = G.n_outputs();
     load_property(G);
+    load_structure(G);
   }
 
   PebblingModel& PebblingModel::constrained(
@@ -46,20 +52,17 @@ namespace pdr::pebbling
   {
     transition.resize(0);
 
-    for (size_t i = 0; i < vars().size(); i++) // every node has a transition
+    for (dag::node_t i = 0; i < G.n_nodes(); i++) // every node has a transition
     {
-      string name = vars(i).to_string();
       // pebble if all children are pebbled now and next
       // or unpebble if all children are pebbled now and next
-      for (string const& child : G.get_children(name))
+      for (dag::node_t child : G.children(i))
       {
-        expr child_node   = ctx.bool_const(child.c_str());
-        expr child_node_p = vars.p(child_node);
         // clang-format off
-        transition.push_back( vars(i) || !vars.p(i) || child_node);
-        transition.push_back(!vars(i) ||  vars.p(i) || child_node);
-        transition.push_back( vars(i) || !vars.p(i) || child_node_p);
-        transition.push_back(!vars(i) ||  vars.p(i) || child_node_p);
+        transition.push_back( vars(i) || !vars.p(i) || vars(child));
+        transition.push_back(!vars(i) ||  vars.p(i) || vars(child));
+        transition.push_back( vars(i) || !vars.p(i) || vars.p(child));
+        transition.push_back(!vars(i) ||  vars.p(i) || vars.p(child));
         // clang-format on
       }
     }
@@ -68,7 +71,11 @@ namespace pdr::pebbling
   void PebblingModel::load_pebble_transition_z3tseytin(dag::Graph const& G)
   {
     load_pebble_transition_raw2(G);
-    transition = z3ext::tseytin::to_cnf_vec(z3::mk_and(transition));
+    // encode node by node, no conjunction over the whole graph is built
+    z3ext::tseytin::Encoder cnf(ctx);
+    for (expr const& e : transition)
+      cnf.add(e);
+    transition = cnf.clauses();
   }
 
   void PebblingModel::load_pebble_transition_tseytin_custom(dag::Graph const& G)
@@ -76,29 +83,26 @@ namespace pdr::pebbling
     using namespace z3ext::tseytin;
     transition.resize(0);
     // ((pv,i ^ pv,i+1 ) => (pw,i & pw,i+1 ))
-    std::map<string, expr> stay_expr;
-    for (string const& n : G.nodes)
+    expr_vector stay_expr(ctx);
+    for (dag::node_t n = 0; n < G.n_nodes(); n++)
     {
-      string stay_name = fmt::format("_stay[{}]_", n);
-      expr curr        = ctx.bool_const(n.c_str());
-      expr next        = vars.p(curr);
-
-      expr stay = add_and(transition, stay_name, curr, next);
-      stay_expr.emplace(n, stay);
+      string stay_name = fmt::format("_stay[{}]_", G.name_of(n));
+      stay_expr.push_back(add_and(transition, stay_name, vars(n), vars.p(n)));
     }
 
     expr_vector moves(ctx);
-    for (size_t i = 0; i < vars().size(); i++) // every node has a transition
+    for (dag::node_t i = 0; i < G.n_nodes(); i++) // every node has a transition
     {
-      string name      = vars(i).to_string();
-      string flip_name = fmt::format("_flip[{}]_", name);
-      expr flip        = add_xor(transition, flip_name, vars(i), vars.p(i));
+      string const& name = G.name_of(i);
+      string flip_name   = fmt::format("_flip[{}]_", name);
+      expr flip          = add_xor(transition, flip_name, vars(i), vars.p(i));
       // pebble if all children are pebbled now and next
       // or unpebble if all children are pebbled now and next
-      for (string const& child : G.get_children(name))
+      for (dag::node_t child : G.children(i))
       {
-        expr child_stay = stay_expr.at(child);
-        string move_str = fmt::format("_flip[{}] => stay[{}]_", name, child);
+        expr child_stay = stay_expr[child];
+        string move_str =
+            fmt::format("_flip[{}] => stay[{}]_", name, G.name_of(child));
         expr move       = add_implies(transition, move_str, flip, child_stay);
         moves.push_back(move);
       }
@@ -111,17 +115,14 @@ namespace pdr::pebbling
   {
     transition.resize(0);
 
-    for (size_t i = 0; i < vars().size(); i++) // every node has a transition
+    for (dag::node_t i = 0; i < G.n_nodes(); i++) // every node has a transition
     {
-      string name      = vars(i).to_string();
       expr parent_flip = vars(i) ^ vars.p(i);
       // pebble if all children are pebbled now and next
       // or unpebble if all children are pebbled now and next
-      for (string const& child : G.get_children(name))
+      for (dag::node_t child : G.children(i))
       {
-        expr child_node    = ctx.bool_const(child.c_str());
-        expr child_node_p  = vars.p(child_node);
-        expr child_pebbled = child_node & child_node_p;
+        expr child_pebbled = vars(child) & vars.p(child);
 
         transition.push_back(z3::implies(parent_flip, child_pebbled));
       }
@@ -132,19 +133,16 @@ namespace pdr::pebbling
   {
     transition.resize(0);
 
-    for (size_t i = 0; i < vars().size(); i++) // every node has a transition
+    for (dag::node_t i = 0; i < G.n_nodes(); i++) // every node has a transition
     {
-      string name      = vars(i).to_string();
       expr parent_flip = vars(i) ^ vars.p(i);
       // pebble if all children are pebbled now and next
       // or unpebble if all children are pebbled now and next
       expr_vector children_pebbled(ctx);
-      for (string const& child : G.get_children(name))
+      for (dag::node_t child : G.children(i))
       {
-        expr child_node   = ctx.bool_const(child.c_str());
-        expr child_node_p = vars.p(child_node);
-        children_pebbled.push_back(child_node);
-        children_pebbled.push_back(child_node_p);
+        children_pebbled.push_back(vars(child));
+        children_pebbled.push_back(vars.p(child));
       }
       transition.push_back(
           z3::implies(parent_flip, z3::mk_and(children_pebbled)));
@@ -154,32 +152,123 @@ namespace pdr::pebbling
   void PebblingModel::load_property(dag::Graph const& G)
   {
     // final nodes are pebbled and others are not
-    for (expr const& e : vars())
+    for (dag::node_t i = 0; i < G.n_nodes(); i++)
     {
-      if (G.is_output(e.to_string()))
-        n_property.add(e);
+      if (G.is_output(i))
+        n_property.add(vars(i));
       else
-        n_property.add(!e);
+        n_property.add(!vars(i));
     }
     n_property.finish();
 
     // final nodes are unpebbled and others are
     expr_vector disjunction(ctx);
-    for (expr const& e : vars())
+    for (dag::node_t i = 0; i < G.n_nodes(); i++)
     {
-      if (G.is_output(e.to_string()))
-        disjunction.push_back(!e);
+      if (G.is_output(i))
+        disjunction.push_back(!vars(i));
       else
-        disjunction.push_back(e);
+        disjunction.push_back(vars(i));
     }
     property.add(z3::mk_or(disjunction));
     property.finish();
   }
 
-  void PebblingModel::constrain(std::optional<unsigned> new_p)
+  void PebblingModel::load_pebble_counters(size_t cap)
   {
+    using z3ext::tseytin::add_totalizer;
+
     constraint.resize(0);
-    assert(constraint.size() == 0);
+    count   = add_totalizer(constraint, "_count_", vars(), cap);
+    count_p = add_totalizer(constraint, "_count_p_", vars.p(), cap);
+  }
+
+  void PebblingModel::load_structure(dag::Graph const& G)
+  {
+    const size_t n = vars().size();
+    for (size_t i = 0; i < n; i++)
+    {
+      node_index.emplace(vars(i).id(), i);
+      node_index.emplace(vars.p(i).id(), i);
+    }
+
+    child_nodes.assign(n, {});
+    parent_nodes.assign(n, {});
+    for (dag::node_t i = 0; i < n; i++)
+    {
+      for (dag::node_t child : G.children(i))
+      {
+        child_nodes[i].push_back(child);
+        parent_nodes[child].push_back(i);
+      }
+    }
+  }
+
+  std::vector<expr> PebblingModel::lift(
+      std::vector<expr> const& pred, std::vector<expr> const& succ) const
+  {
+    using z3ext::strip_not;
+    const size_t n = vars().size();
+
+    // unknown values are empty, index n is never known
+    std::vector<std::optional<bool>> now(n + 1), next(n + 1);
+    auto assign = [this](std::vector<std::optional<bool>>& values,
+                      std::vector<expr> const& cube)
+    {
+      for (expr const& l : cube)
+      {
+        auto found = node_index.find(strip_not(l).id());
+        if (found != node_index.end())
+          values[found->second] = !l.is_not();
+      }
+    };
+    assign(now, pred);
+    assign(next, succ);
+
+    // node i makes a valid step for every value of the unknowns: it stays,
+    // or its children are pebbled now and next so it may flip
+    auto steps = [&](size_t i)
+    {
+      if (now[i] && next[i] && *now[i] == *next[i])
+        return true;
+      for (size_t c : child_nodes[i])
+        if (now[c] != true || next[c] != true)
+          return false;
+      return true;
+    };
+
+    for (size_t i = 0; i < n; i++)
+      if (!steps(i)) // succ is not a full successor of pred
+        return pred;
+
+    std::vector<expr> rv;
+    for (expr const& l : pred)
+    {
+      auto found = node_index.find(strip_not(l).id());
+      if (found == node_index.end())
+      {
+        rv.push_back(l);
+        continue;
+      }
+
+      size_t i = found->second;
+      std::optional<bool> value = now[i];
+      now[i].reset();
+      bool dropped = steps(i) && std::all_of(parent_nodes[i].begin(),
+                                     parent_nodes[i].end(), steps);
+      if (!dropped)
+      {
+        now[i] = value;
+        rv.push_back(l);
+      }
+    }
+
+    return rv;
+  }
+
+  void PebblingModel::constrain(std::optional<unsigned> new_p)
+  {
+    constraint_assumptions.resize(0);
 
     if (new_p && pebble_constraint)
     {
@@ -196,11 +285,20 @@ namespace pdr::pebbling
     else
       diff = Diff_t::none;
 
-    if (new_p)
+    // a bound of n_nodes() or more is always satisfied and needs no counter
+    if (new_p && *new_p < n_nodes())
     {
-#warning TODO: only need current OR next constraint??
-      constraint.push_back(z3::atmost(vars, *new_p));
-      constraint.push_back(z3::atmost(vars.p(), *new_p));
+      // the totalizers have O(n * cap) clauses, so they only count as far as
+      // the largest bound so far. constraining never grows them, relaxing
+      // doubles them
+      if (count.size() <= *new_p)
+      {
+        size_t cap = std::max<size_t>(*new_p + 1, 2 * count.size());
+        load_pebble_counters(std::min(cap, n_nodes()));
+      }
+
+      constraint_assumptions.push_back(!count.at(*new_p));
+      constraint_assumptions.push_back(!count_p.at(*new_p));
     }
 
     pebble_constraint = new_p;
@@ -215,7 +313,9 @@ namespace pdr::pebbling
 
   const expr PebblingModel::get_constraint_current() const 
   {
-    return constraint[0];
+    if (!pebble_constraint)
+      return ctx.bool_val(true);
+    return z3::atmost(vars(), *pebble_constraint);
   }
 
   unsigned PebblingModel::state_size() const 
@@ -226,11 +326,7 @@ namespace pdr::pebbling
   const std::string PebblingModel::constraint_str() const
   {
     if (pebble_constraint)
-    {
-      assert(!constraint.empty());
       return fmt::format("cardinality {}", *pebble_constraint);
-    }
-    assert(constraint.empty());
     return "no constraint";
   }
 
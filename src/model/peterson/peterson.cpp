@@ -4,6 +4,7 @@
 #include <fmt/color.h>
 #include <fmt/core.h>
 #include <fstream>
+#include <functional>
 #include <iostream>
 #include <iterator>
 #include <map>
@@ -297,6 +298,16 @@ namespace pdr::peterson
     append_names(proc_last);
     append_names(switch_count);
 
+    // register the bits for extract_state(). last[0] holds no bits
+    for (numrep_t i = 0; i < N; i++)
+    {
+      pc_sym.push_back(symbols.add(pc.at(i)));
+      level_sym.push_back(symbols.add(level.at(i)));
+      last_sym.push_back(symbols.add(last.at(i)));
+    }
+    proc_last_sym    = symbols.add(proc_last);
+    switch_count_sym = symbols.add(switch_count);
+
     return rv;
   }
 
@@ -377,6 +388,154 @@ namespace pdr::peterson
     return max_switches;
   }
 
+  vector<vector<expr>> PetersonModel::symmetric(vector<expr> const& cube) const
+  {
+    using mysat::primed::lit_type;
+    using mysat::primed::Symbol;
+
+    // what each owner in symbols holds
+    enum class Role
+    {
+      pc,
+      level,
+      id,
+      other
+    };
+    vector<std::pair<Role, numrep_t>> role(symbols.size(), { Role::other, 0 });
+    vector<BitVec const*> id_vec(symbols.size(), nullptr);
+    for (numrep_t i = 0; i < N; i++)
+    {
+      role[pc_sym[i]]    = { Role::pc, i };
+      role[level_sym[i]] = { Role::level, i };
+      if (i > 0)
+      {
+        role[last_sym[i]]   = { Role::id, i };
+        id_vec[last_sym[i]] = &last[i];
+      }
+    }
+    role[proc_last_sym]   = { Role::id, 0 };
+    id_vec[proc_last_sym] = &proc_last;
+
+    // the bits that cube fixes per owner, and their values
+    vector<Symbol const*> sym;
+    vector<numrep_t> mask(symbols.size(), 0), value(symbols.size(), 0);
+    sym.reserve(cube.size());
+    for (expr const& l : cube)
+    {
+      Symbol const* s = symbols.find(l);
+      if (!s || s->type != lit_type::base)
+        return {};
+      sym.push_back(s);
+      mask[s->owner] |= numrep_t(1) << s->bit;
+      if (!l.is_not())
+        value[s->owner] |= numrep_t(1) << s->bit;
+    }
+
+    // the movable processes that cube refers to
+    vector<bool> mentioned(p, false);
+    auto mention = [&](numrep_t i)
+    {
+      if (i > 0 && i < p)
+        mentioned[i] = true;
+    };
+    for (size_t owner = 0; owner < symbols.size(); owner++)
+    {
+      if (!mask[owner])
+        continue;
+      auto [r, i] = role[owner];
+      if (r == Role::pc || r == Role::level)
+        mention(i);
+      else if (r == Role::id)
+      {
+        // a partial id describes a set of processes that need not map
+        // onto a cube
+        if (mask[owner] != (numrep_t(1) << id_vec[owner]->size) - 1)
+          return {};
+        mention(value[owner]);
+      }
+    }
+
+    vector<numrep_t> from;
+    for (numrep_t i = 1; i < p; i++)
+      if (mentioned[i])
+        from.push_back(i);
+    if (from.empty())
+      return {};
+
+    // sigma renames the mentioned processes, everything else is fixed
+    vector<numrep_t> sigma(N);
+    std::iota(sigma.begin(), sigma.end(), 0);
+    auto rename = [&](numrep_t v)
+    { return v > 0 && v < p && mentioned[v] ? sigma[v] : v; };
+
+    auto key = [](vector<expr> const& c)
+    {
+      vector<unsigned> ids;
+      for (expr const& l : c)
+        ids.push_back(l.id());
+      std::sort(ids.begin(), ids.end());
+      return ids;
+    };
+    set<vector<unsigned>> seen{ key(cube) };
+    vector<vector<expr>> rv;
+
+    auto image = [&]()
+    {
+      vector<expr> img;
+      img.reserve(cube.size());
+      for (size_t j = 0; j < cube.size(); j++)
+      {
+        auto [r, i] = role[sym[j]->owner];
+        unsigned bit = sym[j]->bit;
+        switch (r)
+        {
+          case Role::pc:
+            img.push_back(cube[j].is_not() ? !pc[sigma[i]](bit)
+                                           : pc[sigma[i]](bit));
+            break;
+          case Role::level:
+            img.push_back(cube[j].is_not() ? !level[sigma[i]](bit)
+                                           : level[sigma[i]](bit));
+            break;
+          case Role::id: break; // whole values, below
+          case Role::other: img.push_back(cube[j]); break;
+        }
+      }
+      for (size_t owner = 0; owner < symbols.size(); owner++)
+        if (mask[owner] && role[owner].first == Role::id)
+          for (expr const& l : id_vec[owner]->uint(rename(value[owner])))
+            img.push_back(l);
+
+      if (seen.insert(key(img)).second)
+        rv.push_back(std::move(img));
+    };
+
+    // every injective map of the mentioned processes into 1 .. p-1
+    vector<bool> used(p, false);
+    std::function<void(size_t)> assign = [&](size_t k)
+    {
+      if (rv.size() >= SYMMETRY_MAX_IMAGES)
+        return;
+      if (k == from.size())
+      {
+        image();
+        return;
+      }
+      for (numrep_t t = 1; t < p; t++)
+      {
+        if (used[t])
+          continue;
+        used[t]         = true;
+        sigma[from[k]]  = t;
+        assign(k + 1);
+        used[t] = false;
+      }
+    };
+    assign(0);
+
+    return rv;
+  }
+
   expr if_then_else(const expr& i, const expr& t, const expr& e)
   {
     // return (!i || t) && (i || e); // i => t || !i => e
@@ -834,6 +993,79 @@ namespace pdr::peterson
       std::cout << "n_property - four_crit: unsat" << std::endl;
   }
 
+  bool PetersonModel::test_symmetry(unsigned steps)
+  {
+    using std::cout;
+    using std::endl;
+    using std::map;
+
+    cout << "test_symmetry:\nn procs = " << p << ", steps = " << steps << endl;
+
+    // the step at which each state is first reached
+    map<PetersonState, unsigned> depth;
+    vector<PetersonState> layer{ extract_state(initial) };
+    depth.emplace(layer.front(), 0);
+    for (unsigned k = 1; k <= steps && !layer.empty(); k++)
+    {
+      vector<PetersonState> next_layer;
+      for (PetersonState const& source : layer)
+        for (PetersonState const& dest : successors(source))
+          if (depth.emplace(dest, k).second)
+            next_layer.push_back(dest);
+      layer = std::move(next_layer);
+    }
+
+    // a renaming is a bijection on states, so checking whole states covers
+    // the images of partial cubes too
+    bool ok = true;
+    size_t n_images{ 0 };
+    for (auto const& [state, k] : depth)
+    {
+      vector<expr> lits = z3ext::convert(state.cube(*this));
+      for (vector<expr> const& image : symmetric(lits))
+      {
+        n_images++;
+        PetersonState image_state = extract_state(z3ext::convert(image));
+        auto found                = depth.find(image_state);
+
+        if (image.size() != lits.size())
+        {
+          ok = false;
+          cout << format("image of size {} for a cube of size {}: {}",
+                      image.size(), lits.size(), image_state.inline_string())
+               << endl;
+        }
+        // images of the last layer may first appear beyond the bound
+        if (k < steps && (found == depth.end() || found->second != k))
+        {
+          ok = false;
+          cout << format("{} is reached at step {}, its image {} ",
+                      state.inline_string(), k, image_state.inline_string())
+               << (found == depth.end()
+                          ? string("is not")
+                          : format("at step {}", found->second))
+               << endl;
+        }
+      }
+    }
+
+    cout << format("{} states, {} images: {}", depth.size(), n_images,
+                ok ? "ok" : "FAILED")
+         << endl;
+    return ok;
+  }
+
+  bool PetersonModel::check_symmetry(z3::context& c, unsigned steps)
+  {
+    bool ok = true;
+    for (numrep_t procs : { 3u, 4u })
+    {
+      PetersonModel model(c, procs, procs, {});
+      ok = model.test_symmetry(steps) && ok;
+    }
+    return ok;
+  }
+
   void PetersonModel::test_room()
   {
     using mysat::primed::lit_type;
@@ -945,19 +1177,20 @@ namespace pdr::peterson
 
     // if (type == Internals::mine)
     // {
+    // one pass over the cube, last[0] has no bits and stays 0
+    const vector<numrep_t> values = symbols.decode(cube, t);
     for (numrep_t i = 0; i < N; i++)
     {
-      s.pc.at(i)    = pc.at(i).extract_value(cube, t);
-      s.level.at(i) = level.at(i).extract_value(cube, t);
+      s.pc.at(i)    = values.at(pc_sym.at(i));
+      s.level.at(i) = values.at(level_sym.at(i));
       // s.free.at(i)  = free.at(i).extract_value(cube, t);
-      if (i > 0)
-        s.last.at(i) = last.at(i).extract_value(cube, t);
+      s.last.at(i) = values.at(last_sym.at(i));
     }
 
     if (max_switches)
     {
-      s.proc_last    = proc_last.extract_value(cube, t);
-      s.switch_count = switch_count.extract_value(cube, t);
+      s.proc_last    = values.at(proc_last_sym);
+      s.switch_count = values.at(switch_count_sym);
     }
     else
     {
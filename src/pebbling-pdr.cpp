@@ -1,4 +1,5 @@
-﻿#include "bounded.h"
+﻿#include "aiger-model.h"
+#include "bounded.h"
 #include "cli-parse.h"
 #include "dag.h"
 #include "experiments.h"
@@ -7,12 +8,14 @@
 #include "io.h"
 #include "logger.h"
 #include "mockturtle/networks/klut.hpp"
+#include "parse_aiger.h"
 #include "parse_bench.h"
 #include "parse_tfc.h"
 #include "pdr-context.h"
 #include "pdr.h"
 #include "pebbling-experiments.h"
 #include "pebbling-model.h"
+#include "portfolio.h"
 #include "peterson-experiments.h"
 #include "peterson-result.h"
 #include "peterson.h"
@@ -47,13 +50,23 @@ using namespace my::cli;
 using namespace my::io;
 
 // aliases
-using ModelVariant =
-    std::variant<pdr::pebbling::PebblingModel, pdr::peterson::PetersonModel>;
+using ModelVariant = std::variant<pdr::pebbling::PebblingModel,
+    pdr::peterson::PetersonModel, pdr::aiger::AigerModel>;
 
 // algorithm handling
-ModelVariant construct_model(
-    ArgumentList& args, pdr::Context& context, pdr::Logger& log);
+// if show: also write the model's description and image
+ModelVariant construct_model(ArgumentList& args,
+    pdr::Context& context,
+    pdr::Logger& log,
+    bool show = true);
+// write the graph's description, and its image only for --show-only
+void show_graph(ArgumentList const& args, dag::Graph const& G);
+pdr::IModel& get_imodel(ModelVariant& model);
+void write_pdr_result(
+    ArgumentList& args, ModelVariant const& model, pdr::PdrResult const& res);
 void handle_pdr(ArgumentList& args, pdr::Context context, pdr::Logger& log);
+void handle_portfolio(
+    ArgumentList& args, pdr::Context context, pdr::Logger& log);
 void handle_ipdr(ArgumentList& args, pdr::Context context, pdr::Logger& log);
 void handle_bounded(ArgumentList& args, pdr::Context context, pdr::Logger& log);
 void handle_experiment(ArgumentList& args, pdr::Logger& log);
@@ -82,9 +95,20 @@ int main(int argc, char* argv[])
   }
 
   z3::context ctx;
+
+  if (auto peter = my::variant::get_cref<model_t::Peterson>(args.model);
+      peter && peter->get().symmetry_check)
+  {
+    bool ok = pdr::peterson::PetersonModel::check_symmetry(
+        ctx, *peter->get().symmetry_check);
+    return ok ? 0 : 1;
+  }
+
   pdr::Context context(ctx, args);
 
-  if (std::holds_alternative<algo::t_PDR>(args.algorithm))
+  if (std::holds_alternative<algo::t_PDR>(args.algorithm) && args.portfolio)
+    handle_portfolio(args, std::move(context), logger);
+  else if (std::holds_alternative<algo::t_PDR>(args.algorithm))
     handle_pdr(args, std::move(context), logger);
   else if (std::holds_alternative<algo::t_IPDR>(args.algorithm))
     handle_ipdr(args, std::move(context), logger);
@@ -120,21 +144,44 @@ std::ostream& operator<<(std::ostream& o, std::exception const& e)
   return o;
 }
 
+void show_graph(ArgumentList const& args, dag::Graph const& G)
+{
+  std::string destination = args.folders.model_dir / "dag";
+  // laying out the image is slow for large graphs, so batch runs skip it
+  if (args.onlyshow)
+    G.show(destination, true, true);
+  else
+    G.describe(destination, true, false);
+}
+
 ModelVariant construct_model(
-    ArgumentList& args, pdr::Context& context, pdr::Logger& log)
+    ArgumentList& args, pdr::Context& context, pdr::Logger& log, bool show)
 {
   using my::variant::get_cref;
 
   if (auto pebbling = get_cref<model_t::Pebbling>(args.model))
   {
-    dag::Graph G = model_t::make_graph(pebbling->get().src);
-    G.show(args.folders.model_dir / "dag", true, args.onlyshow);
+    dag::Graph G = model_t::make_graph(pebbling->get());
+    if (show)
+      show_graph(args, G);
     log.stats.is_pebbling(G);
 
     return pdr::pebbling::PebblingModel(args, context.z3_ctx, G)
         .constrained(pebbling->get().max_pebbles);
   }
 
+  if (auto aiger = get_cref<model_t::Aiger>(args.model))
+  {
+    parse::Aiger aig = parse::read_aiger(aiger->get().file.string());
+    log.stats.is_aiger(aig.inputs.size(), aig.latches.size(), aig.ands.size());
+
+    pdr::aiger::AigerModel aig_model(args, context.z3_ctx, aig);
+    if (show)
+      aig_model.show(args.folders.model_file);
+
+    return aig_model;
+  }
+
   auto peterson = get_cref<model_t::Peterson>(args.model);
   assert(peterson);
 
@@ -144,7 +191,8 @@ ModelVariant construct_model(
   auto peter = pdr::peterson::PetersonModel::constrained_switches(
       context.z3_ctx, procs, switch_bound);
   log.stats.is_peter(procs, switch_bound);
-  peter.show(args.folders.model_file);
+  if (show)
+    peter.show(args.folders.model_file);
   // peter.test_room();
 
   return peter;
@@ -184,6 +232,24 @@ void handle_pdr(ArgumentList& args, pdr::Context context, pdr::Logger& log)
   std::ofstream graph = args.folders.file_in_analysis("tex");
   graph << log.graph.get();
 
+  write_pdr_result(args, model, res);
+
+  std::visit(
+      [&](vPDR& a) { a.show_solver(args.folders.solver_dump); }, algorithm);
+}
+
+pdr::IModel& get_imodel(ModelVariant& model)
+{
+  return std::visit([](pdr::IModel& m) -> pdr::IModel& { return m; }, model);
+}
+
+void write_pdr_result(
+    ArgumentList& args, ModelVariant const& model, pdr::PdrResult const& res)
+{
+  using namespace pdr;
+  using my::variant::visitor;
+  using std::endl;
+
   std::cout << "result" << std::endl;
   tabulate::Table T = res.get_table();
 
@@ -207,9 +273,84 @@ void handle_pdr(ArgumentList& args, pdr::Context context, pdr::Logger& log)
       model);
   std::cout << trace;
   args.folders.trace_file << trace;
+}
 
-  std::visit(
-      [&](vPDR& a) { a.show_solver(args.folders.solver_dump); }, algorithm);
+void handle_portfolio(
+    ArgumentList& args, pdr::Context context, pdr::Logger& log)
+{
+  using namespace pdr;
+  using fmt::format;
+
+  // an additional pdr instance with its own z3 context, model and logger
+  struct Instance
+  {
+    z3::context z3_ctx;
+    Logger log;
+    Context ctx;
+    ModelVariant model;
+    PDR alg;
+
+    Instance(ArgumentList& args,
+        Portfolio& portfolio,
+        unsigned seed,
+        unsigned i)
+        : log(args.folders.file_in_analysis(format("log-{}", i), "log"), {},
+              OutLvl::silent,
+              Statistics(trunc_file(
+                  args.folders.file_in_analysis(format("stats-{}", i), "stats"))),
+              format("pdr_logger_{}", i)),
+          ctx(portfolio.configure(Context(z3_ctx, args, seed), i)),
+          model(construct_model(args, ctx, log, false)),
+          alg(args, ctx, log, get_imodel(model))
+    {
+    }
+  };
+
+  Portfolio portfolio(args.share_lemmas);
+  Context first_ctx  = portfolio.configure(context, 0);
+  ModelVariant model = construct_model(args, first_ctx, log);
+
+  if (args.onlyshow)
+    return;
+
+  PDR first(args, first_ctx, log, get_imodel(model));
+  portfolio.add(first);
+
+  std::vector<std::unique_ptr<Instance>> others;
+  for (unsigned i{ 1 }; i < *args.portfolio; i++)
+  {
+    others.push_back(
+        std::make_unique<Instance>(args, portfolio, context.seed, i));
+    portfolio.add(others.back()->alg);
+  }
+
+  std::string model_name = model_t::get_name(args.model);
+  log.graph.reset(model_name, "pdr");
+  for (auto const& o : others)
+    o->log.graph.reset(model_name, "pdr");
+
+  for (size_t i{ 0 }; i < portfolio.size(); i++)
+  {
+    Context const& c = i == 0 ? first_ctx : others[i - 1]->ctx;
+    std::cout << format("instance {}: seed {}, mic {}, mic_retries {}, ctg {}x{}",
+                     i, c.seed, pdr::mic::to_string(c.mic), c.mic_retries,
+                     c.ctg_max_depth, c.ctg_max_counters)
+              << std::endl;
+  }
+
+  Portfolio::Outcome outcome = portfolio.run();
+  vPDR const& winner = outcome.winner == 0
+                         ? static_cast<vPDR const&>(first)
+                         : others[outcome.winner - 1]->alg;
+  std::cout << format("instance {} finished first", outcome.winner)
+            << std::endl;
+
+  // write stat graph
+  std::ofstream graph = args.folders.file_in_analysis("tex");
+  graph << winner.logger.graph.get();
+
+  write_pdr_result(args, model, outcome.result);
+  winner.show_solver(args.folders.solver_dump);
 }
 
 void handle_ipdr(ArgumentList& args, pdr::Context context, pdr::Logger& log)
@@ -239,6 +380,11 @@ void handle_ipdr(ArgumentList& args, pdr::Context context, pdr::Logger& log)
           { return pebbling::IPDR(args, context, log, m); },
           [&](peterson::PetersonModel& m) -> IPDRVariant
           { return peterson::IPDR(args, context, log, m); },
+          [&](aiger::AigerModel& m) -> IPDRVariant
+          {
+            (void)m;
+            throw std::invalid_argument("IPDR is not supported for aiger.");
+          },
       },
       model));
 
@@ -288,8 +434,8 @@ void handle_bounded(ArgumentList& args, pdr::Context context, pdr::Logger& log)
 
   if (auto pebbling = get_cref<model_t::Pebbling>(args.model))
   {
-    dag::Graph G = model_t::make_graph(pebbling->get().src);
-    G.show(args.folders.model_dir / "dag", true, args.onlyshow);
+    dag::Graph G = model_t::make_graph(pebbling->get());
+    show_graph(args, G);
     log.stats.is_pebbling(G);
 
     BoundedPebbling algorithm(G, args);
@@ -0,0 +1,688 @@
+#include "cdcl.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace mysat::cdcl
+{
+  using std::vector;
+
+  namespace
+  {
+    constexpr double VAR_DECAY    = 0.95;
+    constexpr double CLAUSE_DECAY = 0.999;
+    constexpr int RESTART_BASE    = 100;
+
+    // finite subsequences of the luby-sequence: 1 1 2 1 1 2 4 1 1 2 ...
+    double luby(double y, int x)
+    {
+      int size, seq;
+      for (size = 1, seq = 0; size < x + 1; seq++, size = 2 * size + 1)
+        ;
+
+      while (size - 1 != x)
+      {
+        size = (size - 1) >> 1;
+        seq--;
+        x = x % size;
+      }
+
+      return std::pow(y, seq);
+    }
+  } // namespace
+
+  Solver::Solver(uint32_t seed) : rng(seed) {}
+
+  var_t Solver::new_var()
+  {
+    var_t v = assigns.size();
+    assigns.push_back(lbool::Undef);
+    level.push_back(0);
+    reason.push_back(NONE);
+    polarity.push_back(true); // prefer negative literals
+    seen.push_back(0);
+    watches.emplace_back();
+    watches.emplace_back();
+    // small random activity to break ties based on the seed
+    activity.push_back(std::uniform_real_distribution<double>(0, 1e-5)(rng));
+    heap_index.push_back(-1);
+    heap_insert(v);
+
+    return v;
+  }
+
+  size_t Solver::n_vars() const { return assigns.size(); }
+  size_t Solver::n_clauses() const
+  {
+    return originals.size() + permanent.size();
+  }
+  size_t Solver::n_learnts() const { return learnts.size(); }
+  unsigned Solver::n_scopes() const { return scope_marks.size(); }
+
+  lbool Solver::value(lit_t l) const
+  {
+    lbool v = assigns[var(l)];
+    if (v == lbool::Undef)
+      return v;
+    return (v == lbool::True) != sign(l) ? lbool::True : lbool::False;
+  }
+
+  unsigned Solver::decision_level() const { return trail_lim.size(); }
+  void Solver::new_decision_level() { trail_lim.push_back(trail.size()); }
+
+  void Solver::enqueue(lit_t l, cref_t from)
+  {
+    assert(value(l) == lbool::Undef);
+    assigns[var(l)] = sign(l) ? lbool::False : lbool::True;
+    level[var(l)]   = decision_level();
+    reason[var(l)]  = from;
+    trail.push_back(l);
+  }
+
+  void Solver::cancel_until(unsigned lvl)
+  {
+    if (decision_level() <= lvl)
+      return;
+
+    for (size_t i = trail.size(); i > trail_lim[lvl]; i--)
+    {
+      var_t v     = var(trail[i - 1]);
+      assigns[v]  = lbool::Undef;
+      reason[v]   = NONE;
+      polarity[v] = sign(trail[i - 1]);
+      if (heap_index[v] < 0)
+        heap_insert(v);
+    }
+    trail.resize(trail_lim[lvl]);
+    trail_lim.resize(lvl);
+    qhead = trail.size();
+  }
+
+  // CLAUSE DATABASE
+  //
+  void Solver::add_clause(vector<lit_t> const& lits)
+  {
+    originals.push_back(lits);
+    attach(lits, false);
+  }
+
+  void Solver::add_permanent(vector<lit_t> const& lits)
+  {
+    permanent.push_back(lits);
+    attach(lits, false);
+  }
+
+  void Solver::push() { scope_marks.push_back(originals.size()); }
+
+  void Solver::pop(unsigned n)
+  {
+    assert(n <= scope_marks.size());
+    if (n == 0)
+      return;
+
+    originals.resize(scope_marks[scope_marks.size() - n]);
+    scope_marks.resize(scope_marks.size() - n);
+    rebuild();
+  }
+
+  // simplify the clause at level 0 and add it to the watched database
+  void Solver::attach(vector<lit_t> lits, bool learnt)
+  {
+    if (!learnt)
+    {
+      assert(decision_level() == 0);
+      if (!ok)
+        return;
+
+      std::sort(lits.begin(), lits.end());
+      lits.erase(std::unique(lits.begin(), lits.end()), lits.end());
+      size_t j = 0;
+      for (size_t i = 0; i < lits.size(); i++)
+      {
+        assert(var(lits[i]) < n_vars());
+        if (value(lits[i]) == lbool::True ||
+            (i + 1 < lits.size() && lits[i + 1] == negate(lits[i])))
+          return; // satisfied or tautology
+        if (value(lits[i]) != lbool::False)
+          lits[j++] = lits[i];
+      }
+      lits.resize(j);
+
+      if (lits.empty())
+      {
+        ok = false;
+        return;
+      }
+      if (lits.size() == 1)
+      {
+        enqueue(lits[0], NONE);
+        ok = propagate() == NONE;
+        return;
+      }
+    }
+
+    cref_t cr = clauses.size();
+    watches[lits[0]].push_back({ cr, lits[1] });
+    watches[lits[1]].push_back({ cr, lits[0] });
+    clauses.push_back({ std::move(lits), learnt, false, 0.0 });
+    if (learnt)
+      learnts.push_back(cr);
+  }
+
+  // rebuild the database from the user clauses. drops all learned clauses
+  void Solver::rebuild()
+  {
+    cancel_until(0);
+    for (lit_t l : trail)
+    {
+      assigns[var(l)] = lbool::Undef;
+      reason[var(l)]  = NONE;
+      if (heap_index[var(l)] < 0)
+        heap_insert(var(l));
+    }
+    trail.clear();
+    qhead = 0;
+    ok    = true;
+
+    clauses.clear();
+    learnts.clear();
+    n_deleted = 0;
+    for (auto& w : watches)
+      w.clear();
+
+    for (auto const& c : permanent)
+      attach(c, false);
+    for (auto const& c : originals)
+      attach(c, false);
+  }
+
+  // remove deleted clauses from the arena. only at level 0, where no
+  // reasons are needed
+  void Solver::collect_garbage()
+  {
+    assert(decision_level() == 0);
+    vector<Clause> old;
+    old.swap(clauses);
+    learnts.clear();
+    for (auto& w : watches)
+      w.clear();
+    for (lit_t l : trail)
+      reason[var(l)] = NONE;
+
+    for (Clause& c : old)
+    {
+      if (c.deleted)
+        continue;
+      // level 0 assignments are final: move unassigned literals to the watches
+      std::stable_partition(c.lits.begin(), c.lits.end(),
+          [this](lit_t l) { return value(l) != lbool::False; });
+      if (value(c.lits[0]) == lbool::True || value(c.lits[1]) == lbool::True)
+        continue; // satisfied for good
+      if (value(c.lits[0]) == lbool::False)
+      {
+        ok = false; // cannot happen after full propagation
+        return;
+      }
+      if (value(c.lits[1]) == lbool::False)
+      {
+        enqueue(c.lits[0], NONE);
+        continue;
+      }
+      cref_t cr = clauses.size();
+      watches[c.lits[0]].push_back({ cr, c.lits[1] });
+      watches[c.lits[1]].push_back({ cr, c.lits[0] });
+      if (c.learnt)
+        learnts.push_back(cr);
+      clauses.push_back(std::move(c));
+    }
+    n_deleted = 0;
+    ok        = propagate() == NONE;
+  }
+
+  bool Solver::locked(cref_t cr) const
+  {
+    lit_t l = clauses[cr].lits[0];
+    return reason[var(l)] == cr && value(l) == lbool::True;
+  }
+
+  void Solver::reduce_db()
+  {
+    std::sort(learnts.begin(), learnts.end(),
+        [this](cref_t a, cref_t b)
+        {
+          Clause const &x = clauses[a], &y = clauses[b];
+          return x.lits.size() > 2 &&
+                 (y.lits.size() == 2 || x.activity < y.activity);
+        });
+
+    size_t j = 0;
+    for (size_t i = 0; i < learnts.size(); i++)
+    {
+      Clause& c = clauses[learnts[i]];
+      if (i < learnts.size() / 2 && c.lits.size() > 2 && !locked(learnts[i]))
+      {
+        c.deleted = true;
+        n_deleted++;
+      }
+      else
+        learnts[j++] = learnts[i];
+    }
+    learnts.resize(j);
+  }
+
+  // SEARCH
+  //
+  Solver::cref_t Solver::propagate()
+  {
+    cref_t confl = NONE;
+    while (qhead < trail.size())
+    {
+      lit_t false_lit = negate(trail[qhead++]);
+      vector<Watcher>& ws = watches[false_lit];
+      stats.propagations++;
+
+      size_t i = 0, j = 0;
+      while (i < ws.size())
+      {
+        Watcher w = ws[i];
+        if (value(w.blocker) == lbool::True)
+        {
+          ws[j++] = ws[i++];
+          continue;
+        }
+
+        Clause& c = clauses[w.cref];
+        i++;
+        if (c.deleted)
+          continue;
+
+        vector<lit_t>& lits = c.lits;
+        if (lits[0] == false_lit)
+          std::swap(lits[0], lits[1]);
+        assert(lits[1] == false_lit);
+
+        lit_t first = lits[0];
+        Watcher nw{ w.cref, first };
+        if (first != w.blocker && value(first) == lbool::True)
+        {
+          ws[j++] = nw;
+          continue;
+        }
+
+        bool found = false;
+        for (size_t k = 2; k < lits.size(); k++)
+        {
+          if (value(lits[k]) != lbool::False)
+          {
+            std::swap(lits[1], lits[k]);
+            watches[lits[1]].push_back(nw);
+            found = true;
+            break;
+          }
+        }
+        if (found)
+          continue;
+
+        // clause is unit or conflicting
+        ws[j++] = nw;
+        if (value(first) == lbool::False)
+        {
+          confl = w.cref;
+          qhead = trail.size();
+          while (i < ws.size())
+            ws[j++] = ws[i++];
+        }
+        else
+          enqueue(first, w.cref);
+      }
+      ws.resize(j);
+      if (confl != NONE)
+        break;
+    }
+
+    return confl;
+  }
+
+  // first unique implication point
+  void Solver::analyze(cref_t confl, vector<lit_t>& out, unsigned& bt_level)
+  {
+    int path = 0;
+    lit_t p  = UNDEF;
+    size_t index = trail.size();
+    out.clear();
+    out.push_back(UNDEF); // reserved for the asserting literal
+
+    do
+    {
+      assert(confl != NONE);
+      Clause& c = clauses[confl];
+      if (c.learnt)
+        bump_clause(c);
+
+      for (size_t k = (p == UNDEF ? 0 : 1); k < c.lits.size(); k++)
+      {
+        lit_t q = c.lits[k];
+        var_t v = var(q);
+        if (!seen[v] && level[v] > 0)
+        {
+          bump_var(v);
+          seen[v] = 1;
+          if (level[v] >= (int)decision_level())
+            path++;
+          else
+            out.push_back(q);
+        }
+      }
+
+      while (!seen[var(trail[--index])])
+        ;
+      p       = trail[index];
+      confl   = reason[var(p)];
+      seen[var(p)] = 0;
+      path--;
+    } while (path > 0);
+    out[0] = negate(p);
+
+    // remove literals implied by other literals in the clause
+    vector<lit_t> analyzed(out.begin() + 1, out.end());
+    size_t j = 1;
+    for (size_t i = 1; i < out.size(); i++)
+      if (!redundant(out[i]))
+        out[j++] = out[i];
+    out.resize(j);
+    for (lit_t l : analyzed)
+      seen[var(l)] = 0;
+
+    // second highest level is the backtrack level, move it to the watch
+    bt_level = 0;
+    if (out.size() > 1)
+    {
+      size_t max_i = 1;
+      for (size_t i = 2; i < out.size(); i++)
+        if (level[var(out[i])] > level[var(out[max_i])])
+          max_i = i;
+      std::swap(out[1], out[max_i]);
+      bt_level = level[var(out[1])];
+    }
+  }
+
+  // l is redundant if all literals of its reason are in the learned clause
+  bool Solver::redundant(lit_t l) const
+  {
+    cref_t r = reason[var(l)];
+    if (r == NONE)
+      return false;
+
+    for (size_t k = 1; k < clauses[r].lits.size(); k++)
+    {
+      var_t v = var(clauses[r].lits[k]);
+      if (!seen[v] && level[v] > 0)
+        return false;
+    }
+    return true;
+  }
+
+  // collect the assumptions that imply !p, including p
+  void Solver::analyze_final(lit_t p)
+  {
+    conflict.clear();
+    conflict.push_back(p);
+    if (decision_level() == 0)
+      return;
+
+    seen[var(p)] = 1;
+    for (size_t i = trail.size(); i > trail_lim[0]; i--)
+    {
+      var_t v = var(trail[i - 1]);
+      if (!seen[v])
+        continue;
+
+      if (reason[v] == NONE)
+      {
+        assert(level[v] > 0);
+        conflict.push_back(trail[i - 1]); // a decision is an assumption
+      }
+      else
+      {
+        Clause const& c = clauses[reason[v]];
+        for (size_t k = 1; k < c.lits.size(); k++)
+          if (level[var(c.lits[k])] > 0)
+            seen[var(c.lits[k])] = 1;
+      }
+      seen[v] = 0;
+    }
+    seen[var(p)] = 0;
+  }
+
+  lit_t Solver::pick_branch()
+  {
+    while (!heap.empty())
+    {
+      var_t v = heap_pop();
+      if (assigns[v] == lbool::Undef)
+        return mk_lit(v, polarity[v]);
+    }
+    return UNDEF;
+  }
+
+  lbool Solver::search(int n_conflicts)
+  {
+    int conflicts = 0;
+    vector<lit_t> learnt;
+
+    while (true)
+    {
+      cref_t confl = propagate();
+      if (confl != NONE)
+      {
+        stats.conflicts++;
+        conflicts++;
+        if (decision_level() == 0)
+          return lbool::False;
+
+        unsigned bt_level;
+        analyze(confl, learnt, bt_level);
+        cancel_until(bt_level);
+
+        if (learnt.size() == 1)
+          enqueue(learnt[0], NONE);
+        else
+        {
+          cref_t cr = clauses.size();
+          attach(learnt, true);
+          bump_clause(clauses[cr]);
+          enqueue(learnt[0], cr);
+        }
+        decay();
+        continue;
+      }
+
+      if (n_conflicts >= 0 && conflicts >= n_conflicts)
+      {
+        cancel_until(0);
+        return lbool::Undef;
+      }
+
+      if ((double)learnts.size() - trail.size() >= max_learnts)
+        reduce_db();
+
+      lit_t next = UNDEF;
+      while (decision_level() < assumptions.size())
+      {
+        lit_t p = assumptions[decision_level()];
+        if (value(p) == lbool::True)
+          new_decision_level(); // dummy level
+        else if (value(p) == lbool::False)
+        {
+          analyze_final(p);
+          return lbool::False;
+        }
+        else
+        {
+          next = p;
+          break;
+        }
+      }
+
+      if (next == UNDEF)
+      {
+        stats.decisions++;
+        next = pick_branch();
+        if (next == UNDEF)
+          return lbool::True; // all variables assigned
+      }
+
+      new_decision_level();
+      enqueue(next, NONE);
+    }
+  }
+
+  bool Solver::solve(vector<lit_t> const& assume)
+  {
+    model.clear();
+    conflict.clear();
+    gave_up = false;
+    stats.solves++;
+    if (!ok)
+      return false;
+
+    assert(decision_level() == 0);
+    if (n_deleted > clauses.size() / 2)
+    {
+      collect_garbage();
+      if (!ok)
+        return false;
+    }
+
+    assumptions = assume;
+    max_learnts = std::max(n_clauses() / 3.0, 1000.0);
+
+    lbool status = lbool::Undef;
+    for (int restarts = 0; status == lbool::Undef; restarts++)
+    {
+      if (interrupt && interrupt->load(std::memory_order_relaxed))
+      {
+        gave_up = true;
+        break;
+      }
+      status = search(luby(2, restarts) * RESTART_BASE);
+      max_learnts *= 1.05;
+      stats.restarts++;
+    }
+
+    if (status == lbool::True)
+      model = assigns;
+    else if (status == lbool::False && conflict.empty())
+      ok = false; // unsat without assumptions
+
+    cancel_until(0);
+    return status == lbool::True;
+  }
+
+  lbool Solver::model_value(var_t v) const
+  {
+    assert(v < model.size());
+    return model[v];
+  }
+
+  bool Solver::model_true(lit_t l) const
+  {
+    return (model_value(var(l)) == lbool::True) != sign(l);
+  }
+
+  vector<lit_t> const& Solver::failed() const { return conflict; }
+
+  void Solver::set_interrupt(std::atomic<bool> const* flag) { interrupt = flag; }
+  bool Solver::interrupted() const { return gave_up; }
+
+  // ACTIVITY
+  //
+  void Solver::bump_var(var_t v)
+  {
+    if ((activity[v] += var_inc) > 1e100)
+    {
+      for (double& a : activity)
+        a *= 1e-100;
+      var_inc *= 1e-100;
+    }
+    if (heap_index[v] >= 0)
+      heap_up(heap_index[v]);
+  }
+
+  void Solver::bump_clause(Clause& c)
+  {
+    if ((c.activity += cla_inc) > 1e20)
+    {
+      for (cref_t cr : learnts)
+        clauses[cr].activity *= 1e-20;
+      cla_inc *= 1e-20;
+    }
+  }
+
+  void Solver::decay()
+  {
+    var_inc *= 1 / VAR_DECAY;
+    cla_inc *= 1 / CLAUSE_DECAY;
+  }
+
+  // HEAP (max-heap on activity)
+  //
+  bool Solver::heap_less(var_t a, var_t b) const
+  {
+    return activity[a] > activity[b];
+  }
+
+  void Solver::heap_insert(var_t v)
+  {
+    heap_index[v] = heap.size();
+    heap.push_back(v);
+    heap_up(heap.size() - 1);
+  }
+
+  var_t Solver::heap_pop()
+  {
+    var_t top         = heap[0];
+    heap[0]           = heap.back();
+    heap_index[heap[0]] = 0;
+    heap_index[top]   = -1;
+    heap.pop_back();
+    if (heap.size() > 1)
+      heap_down(0);
+    return top;
+  }
+
+  void Solver::heap_up(size_t i)
+  {
+    var_t v = heap[i];
+    while (i > 0)
+    {
+      size_t parent = (i - 1) / 2;
+      if (!heap_less(v, heap[parent]))
+        break;
+      heap[i]             = heap[parent];
+      heap_index[heap[i]] = i;
+      i                   = parent;
+    }
+    heap[i]       = v;
+    heap_index[v] = i;
+  }
+
+  void Solver::heap_down(size_t i)
+  {
+    var_t v = heap[i];
+    while (2 * i + 1 < heap.size())
+    {
+      size_t child = 2 * i + 1;
+      if (child + 1 < heap.size() && heap_less(heap[child + 1], heap[child]))
+        child++;
+      if (!heap_less(heap[child], v))
+        break;
+      heap[i]             = heap[child];
+      heap_index[heap[i]] = i;
+      i                   = child;
+    }
+    heap[i]       = v;
+    heap_index[v] = i;
+  }
+} // namespace mysat::cdcl
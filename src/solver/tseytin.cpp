@@ -1,4 +1,4 @@
-// Adapted from
+// Clauses adapted from
 // https://github.com/lsils/bill/blob/master/include/bill/sat/tseytin.hpp
 /*
 MIT License
@@ -23,139 +23,304 @@ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
 OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.
 */
+#include "tseytin.h"
 
-/*! \brief Adds CNF clauses for `y = (l_0 and ... and l_{n-1})` to the solver.
- *
- * \param solver Solver
- * \param ls List of literals
- * \return Literal y
- */
-#include "solver.h"
-namespace pdr
+#include <cassert>
+
+namespace z3ext::tseytin
 {
-  // /*! \brief Adds CNF clauses for `y = (a and b)` to the solver.
-  //  *
-  //  * \param solver Solver
-  //  * \param a Literal
-  //  * \param b Literal
-  //  * \return Literal y
-  //  */
-  // template <typename Solver>
-  // lit_type add_tseytin_and(Solver& solver, lit_type const& a, lit_type const& b)
-  // {
-  //   auto const r = solver.add_variable();
-  //   solver.add_clause(
-  //       std::vector{ ~a, ~b, lit_type(r, lit_type::polarities::positive) });
-  //   solver.add_clause(
-  //       std::vector{ a, lit_type(r, lit_type::polarities::negative) });
-  //   solver.add_clause(
-  //       std::vector{ b, lit_type(r, lit_type::polarities::negative) });
-  //   return lit_type(r, lit_type::polarities::positive);
-  // }
-
-  // /*! \brief Adds CNF clauses for `y = (l_0 and ... and l_{n-1})` to the solver.
-  //  *
-  //  * \param solver Solver
-  //  * \param ls List of literals
-  //  * \return Literal y
-  //  */
-  // template <typename Solver>
-  // lit_type add_tseytin_and(Solver& solver, std::vector<lit_type> const& ls)
-  // {
-  //   auto const r = solver.add_variable();
-  //   std::vector<lit_type> cls;
-  //   for (const auto& l : ls)
-  //     cls.emplace_back(~l);
-  //   cls.emplace_back(lit_type(r, lit_type::polarities::positive));
-  //   solver.add_clause(cls);
-  //   for (const auto& l : ls)
-  //     solver.add_clause(
-  //         std::vector{ l, lit_type(r, lit_type::polarities::negative) });
-  //   return lit_type(r, lit_type::polarities::positive);
-  // }
-
-  // /*! \brief Adds CNF clauses for `y = a or b` to the solver.
-  //  *
-  //  * \param solver Solver
-  //  * \param a Literal
-  //  * \param b Literal
-  //  * \return Literal y
-  //  */
-  // template <typename Solver>
-  // lit_type add_tseytin_or(Solver& solver, lit_type const& a, lit_type const& b)
-  // {
-  //   auto const r = solver.add_variable();
-  //   solver.add_clause(
-  //       std::vector{ a, b, lit_type(r, lit_type::polarities::negative) });
-  //   solver.add_clause(
-  //       std::vector{ ~a, lit_type(r, lit_type::polarities::positive) });
-  //   solver.add_clause(
-  //       std::vector{ ~b, lit_type(r, lit_type::polarities::positive) });
-  //   return lit_type(r, lit_type::polarities::positive);
-  // }
-
-  // /*! \brief Adds CNF clauses for `y = (l_0 or ... or l_{n-1})` to the solver.
-  //  *
-  //  * \param solver Solver
-  //  * \param ls List of literals
-  //  * \return Literal y
-  //  */
-  // template <typename Solver>
-  // lit_type add_tseytin_or(Solver& solver, std::vector<lit_type> const& ls)
-  // {
-  //   auto const r = solver.add_variable();
-  //   std::vector<lit_type> cls(ls);
-  //   cls.emplace_back(lit_type(r, lit_type::polarities::negative));
-  //   solver.add_clause(cls);
-  //   for (const auto& l : ls)
-  //     solver.add_clause(
-  //         std::vector{ ~l, lit_type(r, lit_type::polarities::positive) });
-  //   return lit_type(r, lit_type::polarities::positive);
-  // }
-
-  // /*! \brief Adds CNF clauses for `y = (a xor b)` to the solver.
-  //  *
-  //  * \param solver Solver
-  //  * \param a Literal
-  //  * \param b Literal
-  //  * \return Literal y
-  //  */
-  // template <typename Solver>
-  // lit_type add_tseytin_xor(Solver& solver, lit_type const& a, lit_type const& b)
-  // {
-  //   auto const r = solver.add_variable();
-  //   solver.add_clause(
-  //       std::vector{ ~a, ~b, lit_type(r, lit_type::polarities::negative) });
-  //   solver.add_clause(
-  //       std::vector{ ~a, b, lit_type(r, lit_type::polarities::positive) });
-  //   solver.add_clause(
-  //       std::vector{ a, ~b, lit_type(r, lit_type::polarities::positive) });
-  //   solver.add_clause(
-  //       std::vector{ a, b, lit_type(r, lit_type::polarities::negative) });
-  //   return lit_type(r, lit_type::polarities::positive);
-  // }
-
-  // /*! \brief Adds CNF clauses for `y = (a == b)` to the solver.
-  //  *
-  //  * \param solver Solver
-  //  * \param a Literal
-  //  * \param b Literal
-  //  * \return Literal y
-  //  */
-  // template <typename Solver>
-  // lit_type add_tseytin_equals(Solver& solver, lit_type const& a,
-  //                             lit_type const& b)
-  // {
-  //   auto const r = solver.add_variable();
-  //   solver.add_clause(
-  //       std::vector{ ~a, ~b, lit_type(r, lit_type::polarities::positive) });
-  //   solver.add_clause(
-  //       std::vector{ ~a, b, lit_type(r, lit_type::polarities::negative) });
-  //   solver.add_clause(
-  //       std::vector{ a, ~b, lit_type(r, lit_type::polarities::negative) });
-  //   solver.add_clause(
-  //       std::vector{ a, b, lit_type(r, lit_type::polarities::positive) });
-  //   return lit_type(r, lit_type::polarities::positive);
-  // }
-
-} // namespace pdr
+  using std::vector;
+  using z3::expr;
+
+  namespace
+  {
+    // the other direction, as seen through a negation
+    unsigned flip(unsigned mask) { return ((mask & 1u) << 1) | (mask >> 1); }
+
+    expr negate(expr const& e)
+    {
+      if (e.is_true())
+        return e.ctx().bool_val(false);
+      if (e.is_false())
+        return e.ctx().bool_val(true);
+      if (e.is_not())
+        return e.arg(0);
+      return !e;
+    }
+
+    bool is_constant(expr const& e) { return e.is_true() || e.is_false(); }
+
+    bool is_gate(expr const& e)
+    {
+      if (!e.is_app() || !e.is_bool())
+        return false;
+
+      switch (e.decl().decl_kind())
+      {
+        case Z3_OP_AND:
+        case Z3_OP_OR:
+        case Z3_OP_IMPLIES:
+        case Z3_OP_XOR:
+        case Z3_OP_IFF:
+        case Z3_OP_ITE: return true;
+        case Z3_OP_EQ: return e.arg(0).is_bool();
+        default: return false;
+      }
+    }
+  } // namespace
+
+  Encoder::Encoder(z3::context& c) : ctx(c), cnf(c) {}
+
+  void Encoder::add(expr const& e) { assert_(e, true); }
+
+  z3::expr_vector const& Encoder::clauses() const { return cnf; }
+
+  // assert e if sign, else !e
+  void Encoder::assert_(expr const& e, bool sign)
+  {
+    if (e.is_not())
+      return assert_(e.arg(0), !sign);
+
+    // conjunctions are split into separate clauses
+    if ((e.is_and() && sign) || (e.is_or() && !sign))
+    {
+      for (unsigned i = 0; i < e.num_args(); i++)
+        assert_(e.arg(i), sign);
+      return;
+    }
+    if (e.is_implies() && !sign)
+    {
+      assert_(e.arg(0), true);
+      assert_(e.arg(1), false);
+      return;
+    }
+
+    vector<expr> lits;
+    if (e.is_or()) // and sign
+    {
+      for (unsigned i = 0; i < e.num_args(); i++)
+        lits.push_back(lit(e.arg(i), POS));
+    }
+    else if (e.is_and()) // and !sign
+    {
+      for (unsigned i = 0; i < e.num_args(); i++)
+        lits.push_back(negate(lit(e.arg(i), NEG)));
+    }
+    else if (e.is_implies()) // and sign
+    {
+      lits.push_back(negate(lit(e.arg(0), NEG)));
+      lits.push_back(lit(e.arg(1), POS));
+    }
+    else
+      lits.push_back(sign ? lit(e, POS) : negate(lit(e, NEG)));
+
+    clause(lits);
+  }
+
+  expr Encoder::lit(expr const& e, unsigned mask)
+  {
+    if (e.is_not())
+      return negate(lit(e.arg(0), flip(mask)));
+
+    if (!is_gate(e))
+      return e;
+
+    // unordered_map keeps references valid while define() inserts
+    Gate& g = gates.try_emplace(e.id(), Gate{ e, {}, 0 }).first->second;
+    unsigned todo = mask & ~g.defined;
+    if (todo)
+    {
+      g.defined |= todo;
+      define(g, todo);
+    }
+    assert(g.lit);
+    return *g.lit;
+  }
+
+  // sets g.lit: a fresh literal with clauses for "mask", or the literal of a
+  // simpler formula if constants fold the gate away. folding depends only on
+  // the structure of g.node, so every call agrees on g.lit
+  void Encoder::define(Gate& g, unsigned mask)
+  {
+    expr const& e = g.node;
+    switch (e.decl().decl_kind())
+    {
+      case Z3_OP_AND: define_junction(g, mask, true); break;
+      case Z3_OP_OR: define_junction(g, mask, false); break;
+      case Z3_OP_IMPLIES: define_junction(g, mask, false); break;
+      case Z3_OP_XOR: define_xor(g, mask, true); break;
+      case Z3_OP_IFF:
+      case Z3_OP_EQ: define_xor(g, mask, false); break;
+      case Z3_OP_ITE: define_ite(g, mask); break;
+      default: assert(false);
+    }
+  }
+
+  // x = a_0 & ... & a_n or x = a_0 | ... | a_n
+  // a => b is handled as !a | b
+  void Encoder::define_junction(Gate& g, unsigned mask, bool is_and)
+  {
+    expr const& e = g.node;
+    // the literal that decides the junction: false for and, true for or
+    const bool absorbing = !is_and;
+
+    vector<expr> args;
+    for (unsigned i = 0; i < e.num_args(); i++)
+    {
+      expr a = e.is_implies() && i == 0 ? negate(lit(e.arg(0), flip(mask)))
+                                        : lit(e.arg(i), mask);
+      if (is_constant(a))
+      {
+        if (a.is_true() == absorbing)
+        {
+          g.lit = ctx.bool_val(absorbing);
+          return;
+        }
+        continue; // neutral
+      }
+      args.push_back(a);
+    }
+
+    if (args.empty())
+    {
+      g.lit = ctx.bool_val(is_and);
+      return;
+    }
+    if (args.size() == 1)
+    {
+      g.lit = args[0];
+      return;
+    }
+
+    if (!g.lit)
+      g.lit = fresh();
+    expr const& x = *g.lit;
+
+    if (is_and)
+    {
+      // x => a_i
+      if (mask & POS)
+        for (expr const& a : args)
+          clause({ !x, a });
+      // a_0 & ... & a_n => x
+      if (mask & NEG)
+      {
+        vector<expr> c{ x };
+        for (expr const& a : args)
+          c.push_back(negate(a));
+        clause(c);
+      }
+    }
+    else
+    {
+      // x => a_0 | ... | a_n
+      if (mask & POS)
+      {
+        vector<expr> c{ !x };
+        c.insert(c.end(), args.begin(), args.end());
+        clause(c);
+      }
+      // a_i => x
+      if (mask & NEG)
+        for (expr const& a : args)
+          clause({ x, negate(a) });
+    }
+  }
+
+  // x = a ^ b or x = (a == b)
+  void Encoder::define_xor(Gate& g, unsigned mask, bool is_xor)
+  {
+    expr const& e = g.node;
+    if (e.num_args() > 2) // chain n-ary xor
+    {
+      expr chain = e.arg(0);
+      for (unsigned i = 1; i < e.num_args(); i++)
+        chain = chain ^ e.arg(i);
+      g.lit = lit(chain, mask);
+      return;
+    }
+
+    expr a = lit(e.arg(0), BOTH), b = lit(e.arg(1), BOTH);
+    if (is_constant(a) || is_constant(b))
+    {
+      expr c = is_constant(a) ? a : b, o = is_constant(a) ? b : a;
+      // a ^ true = !a, a == true = a
+      g.lit = c.is_true() == is_xor ? negate(o) : o;
+      return;
+    }
+
+    if (!g.lit)
+      g.lit = fresh();
+    expr const& x = *g.lit;
+    if (!is_xor)
+      b = negate(b); // a == b <=> a ^ !b
+
+    // x => a ^ b
+    if (mask & POS)
+    {
+      clause({ !x, a, b });
+      clause({ !x, negate(a), negate(b) });
+    }
+    // a ^ b => x
+    if (mask & NEG)
+    {
+      clause({ x, negate(a), b });
+      clause({ x, a, negate(b) });
+    }
+  }
+
+  // x = c ? t : f
+  void Encoder::define_ite(Gate& g, unsigned mask)
+  {
+    expr const& e = g.node;
+    expr c = lit(e.arg(0), BOTH);
+    if (is_constant(c))
+    {
+      g.lit = lit(e.arg(c.is_true() ? 1 : 2), mask);
+      return;
+    }
+    expr t = lit(e.arg(1), mask), f = lit(e.arg(2), mask);
+
+    if (!g.lit)
+      g.lit = fresh();
+    expr const& x = *g.lit;
+
+    // x => (c => t) & (!c => f)
+    if (mask & POS)
+    {
+      clause({ !x, negate(c), t });
+      clause({ !x, c, f });
+    }
+    // (c & t) | (!c & f) => x
+    if (mask & NEG)
+    {
+      clause({ x, negate(c), negate(t) });
+      clause({ x, c, negate(f) });
+    }
+  }
+
+  expr Encoder::fresh()
+  {
+    return expr(ctx, Z3_mk_fresh_const(ctx, "ts", ctx.bool_sort()));
+  }
+
+  // adds the disjunction of "lits", leaving out false. skipped if it has true
+  void Encoder::clause(vector<expr> const& lits)
+  {
+    z3::expr_vector c(ctx);
+    for (expr const& l : lits)
+    {
+      if (l.is_true())
+        return;
+      if (!l.is_false())
+        c.push_back(l);
+    }
+
+    if (c.empty())
+      cnf.push_back(ctx.bool_val(false));
+    else if (c.size() == 1)
+      cnf.push_back(c[0]);
+    else
+      cnf.push_back(z3::mk_or(c));
+  }
+} // namespace z3ext::tseytin
@@ -8,7 +8,10 @@ namespace pdr
   using my::io::trunc_file;
 
   Logger::Logger(const std::string& log_file,
-      std::optional<std::string_view> pfilename, OutLvl l, Statistics&& s)
+      std::optional<std::string_view> pfilename,
+      OutLvl l,
+      Statistics&& s,
+      const std::string& name)
       : _out(progress_file), stats(std::move(s)), level(l)
   {
     if (pfilename)
@@ -18,14 +21,15 @@ namespace pdr
         throw std::runtime_error("Failed to open " + std::string{ *pfilename });
     }
 
-    init(log_file);
+    init(log_file, name);
   }
 
-  void Logger::init(const std::string& log_file)
+  void Logger::init(const std::string& log_file, const std::string& name)
   {
     // log file truncates
-    spd_logger = spdlog::basic_logger_mt("pdr_logger", log_file, true);
-    spdlog::set_default_logger(spd_logger);
+    spd_logger = spdlog::basic_logger_mt(name, log_file, true);
+    if (name == "pdr_logger")
+      spdlog::set_default_logger(spd_logger);
     spd_logger->set_level(spdlog::level::trace);
     // spdlog::flush_every(std::chrono::seconds(20));
     spdlog::flush_on(spdlog::level::trace);
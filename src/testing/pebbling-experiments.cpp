@@ -75,7 +75,7 @@ namespace pdr::pebbling::experiments
       // new context with new random seed
       z3::context z3_ctx;
       pdr::Context ctx(z3_ctx, args, seeds[i]);
-      PebblingModel ts(args, z3_ctx, model_t::make_graph(ts_descr.src));
+      PebblingModel ts(args, z3_ctx, model_t::make_graph(ts_descr));
       if (bmc)
       {
         bounded::BoundedPebbling algo(ts.dag, args);
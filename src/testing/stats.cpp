@@ -139,9 +139,9 @@ namespace pdr
   void Statistics::is_pebbling(dag::Graph const& G)
   {
     assert(!finished);
-    model_info.emplace("nodes", G.nodes.size());
-    model_info.emplace("edges", G.edges.size());
-    model_info.emplace("outputs", G.output.size());
+    model_info.emplace("nodes", G.n_nodes());
+    model_info.emplace("edges", G.n_edges());
+    model_info.emplace("outputs", G.n_outputs());
     finished = true;
   }
 
@@ -154,6 +154,15 @@ namespace pdr
     finished = true;
   }
 
+  void Statistics::is_aiger(size_t inputs, size_t latches, size_t ands)
+  {
+    assert(!finished);
+    model_info.emplace("inputs", inputs);
+    model_info.emplace("latches", latches);
+    model_info.emplace("ands", ands);
+    finished = true;
+  }
+
   void Statistics::update_peter(unsigned p, unsigned N)
   {
     model_info[PROC_STR]   = p;
@@ -169,7 +178,14 @@ namespace pdr
     obligations_handled.clear();
     generalization.clear();
     generalization_reduction.clear();
+    ctg_blocked.clear();
+    ctg_levels = 0;
     subsumed_cubes.clear();
+    symmetric_cubes.clear();
+    symmetric_queries.clear();
+    inductive_cache_hits.clear();
+    inductive_cache_misses.clear();
+    lift_reduction.clear();
 
     relax_copied_cubes_perc = 0.0;
     pre_relax_F.clear();
@@ -206,9 +222,18 @@ namespace pdr
 
     out << "# Solver" << endl << s.solver_calls << endl;
 
+    out << "# Inductive query cache" << endl
+        << "## Hits" << endl
+        << s.inductive_cache_hits << endl
+        << "## Misses" << endl
+        << s.inductive_cache_misses << endl;
+
     out << "# CTIs" << endl << s.ctis << endl;
 
     out << "# Obligations" << endl << s.obligations_handled << endl;
+    out << fmt::format("## Mean reduction by lifting: {} %",
+               s.lift_reduction * 100.0)
+        << endl;
 
     out << "# Generalization" << endl
         << fmt::format(
@@ -218,6 +243,10 @@ namespace pdr
         << endl
         << fmt::format("## No. limit-violations in MIC: {}", s.mic_limit)
         << endl
+        << fmt::format("## No. levels switched to ctg MIC: {}", s.ctg_levels)
+        << endl
+        << "## Blocked counters-to-generalization" << endl
+        << s.ctg_blocked << endl
         << s.generalization << endl;
 
     out << "# Propagation per iteration" << endl << s.propagation_it << endl;
@@ -226,6 +255,10 @@ namespace pdr
 
     out << "# Subsumed cubes" << endl << s.subsumed_cubes << endl;
 
+    out << "# Blocked symmetric images" << endl << s.symmetric_cubes << endl;
+    out << "# Solver calls to check symmetric images" << endl
+        << s.symmetric_queries << endl;
+
     out << "#" << endl
         << "# Copied cubes during relax ipdr" << endl
         << s.relax_copied_cubes_perc << " %" << endl
@@ -15,7 +15,6 @@
 #include <iterator>
 #include <numeric>
 #include <optional>
-#include <regex>
 #include <spdlog/stopwatch.h>
 #include <sstream>
 #include <stdexcept>
@@ -191,7 +190,6 @@ namespace pdr::test
   {
     using tabulate::Table;
     using z3ext::LitStr;
-    using namespace str::ext;
     assert(last_result == z3::check_result::sat);
 
     vector<vector<LitStr>> rv;
@@ -212,36 +210,26 @@ namespace pdr::test
           fmt::format("\"{}\" is not a valid state in the trace", s));
     };
 
-    // use regex to extract the assignments of "true" and "false" from a state
+    // a state is the application (state b0 b1 ...) of boolean constants
     // they are in order of ts.vars.names()
-    const std::regex marking(R"(\(state((?:\s+(?:true|false))*)\))");
-    std::smatch match;
-
     MYLOG_DEBUG(logger, "Trace markings:");
     for (size_t i{ 0 }; i < states.size(); i++)
     {
-      std::string state_str(states[i].to_string());
-      if (!std::regex_match(state_str, match, marking))
-        throw invalid(state_str);
-      assert(match.size() == 2);
-
-      string mark_string = match[1];
-      trim(mark_string); // remove white spaces at beginning and end
-      // replace all white spaces by " "
-      mark_string = std::regex_replace(mark_string, std::regex("\\s+"), " ");
-
-      vector<string> marks = split(mark_string, ' ');
+      expr const& s = states[i];
+      if (!s.is_app() || s.decl().name().str() != "state" ||
+          s.num_args() != header.size())
+        throw invalid(s.to_string());
 
-      assert(marks.size() == header.size());
       vector<LitStr> state;
-      for (size_t j{ 0 }; j < marks.size(); j++)
+      for (unsigned j{ 0 }; j < s.num_args(); j++)
       {
-        if (marks[j] == "true")
+        expr mark = s.arg(j);
+        if (mark.is_true())
           state.emplace_back(header.at(j), true);
-        else if (marks[j] == "false")
+        else if (mark.is_false())
           state.emplace_back(header.at(j), false);
         else
-          throw invalid(state_str);
+          throw invalid(s.to_string());
       }
       rv.push_back(state);
       MYLOG_DEBUG(logger, "- {}",